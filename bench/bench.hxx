@@ -0,0 +1,76 @@
+// The code here is shared by the benchmark programs in bench/.
+
+#ifndef BENCH_HXX
+#define BENCH_HXX
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// bench_keep(v) stops the optimizer from discarding the computation of v.
+template <typename T>
+inline void bench_keep(T const& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// bench_median_ns(reps, fn) runs fn() reps times and returns the median
+// wall-clock time of one run in nanoseconds.
+template <typename Fn>
+inline double bench_median_ns(std::size_t reps, Fn&& fn) {
+  using clock = std::chrono::steady_clock;
+  std::vector<double> samples;
+  samples.reserve(reps);
+  for (std::size_t i = 0; i != reps; ++i) {
+    auto start = clock::now();
+    fn();
+    auto stop = clock::now();
+    samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+// bench_median_ns(reps, setup, fn) is as above but calls setup() before
+// each run of fn(); only fn() is timed.
+template <typename Setup, typename Fn>
+inline double bench_median_ns(std::size_t reps, Setup&& setup, Fn&& fn) {
+  using clock = std::chrono::steady_clock;
+  std::vector<double> samples;
+  samples.reserve(reps);
+  for (std::size_t i = 0; i != reps; ++i) {
+    setup();
+    auto start = clock::now();
+    fn();
+    auto stop = clock::now();
+    samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  std::sort(samples.begin(), samples.end());
+  return samples[samples.size() / 2];
+}
+
+// Every benchmark writes one CSV record per measurement with these
+// columns so that results from all programs can be concatenated.
+inline void bench_header(std::ostream& os) {
+  os << "suite,benchmark,container,elem_bytes,length,threads,ns_per_op\n";
+}
+
+inline void bench_report(
+  std::ostream& os,
+  std::string const& suite,
+  std::string const& benchmark,
+  std::string const& container,
+  std::size_t elem_bytes,
+  std::size_t length,
+  std::size_t threads,
+  double ns_per_op
+)
+{
+  os << suite << ',' << benchmark << ',' << container << ','
+     << elem_bytes << ',' << length << ',' << threads << ','
+     << ns_per_op << '\n';
+}
+
+#endif // #ifndef BENCH_HXX
@@ -0,0 +1,83 @@
+// Multi-producer/single-consumer throughput: concurrent_dllist<T> against a
+// dllist<T> whose push_back()/pop_front() are wrapped in a std::mutex.
+//
+// For each producer count P, P threads push items_per_run / P items each
+// while one consumer pops all of them. ns_per_op is the wall time of a
+// run divided by the number of items (one push plus one pop each).
+
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dllist.hxx"
+#include "concurrent_dllist.hxx"
+#include "bench.hxx"
+
+class mutex_dllist {
+private:
+  std::mutex mutex_;
+  dllist<std::size_t> list_;
+
+public:
+  void push_back(std::size_t v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    list_.push_back(v);
+  }
+
+  bool try_pop_front(std::size_t& v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (list_.empty()) {
+      return false;
+    }
+    v = list_.front();
+    list_.pop_front();
+    return true;
+  }
+};
+
+template <typename Queue>
+void bench_mpsc(char const* name, std::size_t producers, std::size_t items, std::size_t reps) {
+  std::size_t const per_producer = items / producers;
+  std::size_t const total = per_producer * producers;
+
+  auto ns = bench_median_ns(reps, [&] {
+    Queue q;
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (std::size_t p = 0; p != producers; ++p) {
+      threads.emplace_back([&q, per_producer] {
+        for (std::size_t i = 0; i != per_producer; ++i) {
+          q.push_back(i);
+        }
+      });
+    }
+
+    std::size_t sum = 0;
+    std::size_t v;
+    for (std::size_t n = 0; n != total; ) {
+      if (q.try_pop_front(v)) {
+        sum += v;
+        ++n;
+      }
+    }
+    bench_keep(sum);
+
+    for (auto& t : threads) {
+      t.join();
+    }
+  });
+  bench_report(std::cout, "mpsc", "push_pop", name, sizeof(std::size_t), total, producers, ns / total);
+}
+
+int main()
+{
+  std::size_t const items = std::size_t{1} << 20;
+  bench_header(std::cout);
+  for (std::size_t producers = 1; producers <= 64; producers *= 2) {
+    bench_mpsc<concurrent_dllist<std::size_t>>("concurrent_dllist", producers, items, 5);
+    bench_mpsc<mutex_dllist>("mutex_dllist", producers, items, 5);
+  }
+  return 0;
+}
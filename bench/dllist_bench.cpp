@@ -0,0 +1,171 @@
+// Sequence container operations: dllist<T> (with std::allocator and with
+// dllist_pool_allocator), arena_dllist<T> and unrolled_dllist<T> against
+// std::list<T> and std::deque<T>.
+//
+// Every benchmark is run for several element sizes and list lengths.
+// Containers are filled outside the timed region, each measurement is the
+// median of a fixed number of runs, and ns_per_op is divided by the number
+// of elements touched (swap: by the number of swaps).
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <utility>
+
+#include "dllist.hxx"
+#include "dllist_pool.hxx"
+#include "arena_dllist.hxx"
+#include "unrolled_dllist.hxx"
+#include "bench.hxx"
+
+// The padding of a bench_elem. It is a base class so that no padding
+// takes no space: an empty member (e.g., std::array<unsigned char, 0>)
+// would still take a byte, and made bench_elem<8> 16 bytes.
+template <std::size_t Bytes>
+struct bench_pad {
+  std::array<unsigned char, Bytes> pad{};
+};
+
+template <>
+struct bench_pad<0> {
+};
+
+// An element of Bytes bytes whose first word is a key...
+template <std::size_t Bytes>
+struct bench_elem : bench_pad<Bytes - sizeof(std::size_t)> {
+  std::size_t key;
+
+  bench_elem() : key() {}
+  explicit bench_elem(std::size_t k) : key(k) {}
+};
+
+// Number of middle inserts/erases per run; deque's are O(length) each.
+std::size_t const middle_ops = 256;
+
+template <typename Container>
+void bench_fill(Container& c, std::size_t n) {
+  using value_type = typename Container::value_type;
+  c.clear();
+  for (std::size_t i = 0; i != n; ++i) {
+    c.push_back(value_type(i));
+  }
+}
+
+template <typename Container>
+void bench_container(char const* name, std::size_t n, std::size_t reps) {
+  using value_type = typename Container::value_type;
+  std::size_t const bytes = sizeof(value_type);
+  auto report = [&](char const* benchmark, double ns, std::size_t ops) {
+    bench_report(std::cout, "dllist", benchmark, name, bytes, n, 1, ns / ops);
+  };
+
+  Container c;
+  Container other;
+
+  report("push_back", bench_median_ns(reps, [&] { c.clear(); }, [&] {
+    for (std::size_t i = 0; i != n; ++i) {
+      c.push_back(value_type(i));
+    }
+  }), n);
+
+  report("push_front", bench_median_ns(reps, [&] { c.clear(); }, [&] {
+    for (std::size_t i = 0; i != n; ++i) {
+      c.push_front(value_type(i));
+    }
+  }), n);
+
+  report("pop_back", bench_median_ns(reps, [&] { bench_fill(c, n); }, [&] {
+    for (std::size_t i = 0; i != n; ++i) {
+      c.pop_back();
+    }
+  }), n);
+
+  report("pop_front", bench_median_ns(reps, [&] { bench_fill(c, n); }, [&] {
+    for (std::size_t i = 0; i != n; ++i) {
+      c.pop_front();
+    }
+  }), n);
+
+  // Middle insert/erase through an iterator that stays at the same spot...
+  typename Container::iterator mid;
+  auto to_middle = [&] {
+    bench_fill(c, n);
+    mid = std::next(c.begin(), n / 2);
+  };
+  report("insert_middle", bench_median_ns(reps, to_middle, [&] {
+    for (std::size_t i = 0; i != middle_ops; ++i) {
+      mid = c.insert(mid, value_type(i));
+    }
+  }), middle_ops);
+
+  auto to_middle_padded = [&] {
+    bench_fill(c, n + middle_ops);
+    mid = std::next(c.begin(), n / 2);
+  };
+  report("erase_middle", bench_median_ns(reps, to_middle_padded, [&] {
+    for (std::size_t i = 0; i != middle_ops; ++i) {
+      mid = c.erase(mid);
+    }
+  }), middle_ops);
+
+  bench_fill(c, n);
+  report("traverse_forward", bench_median_ns(reps, [&] {
+    std::size_t sum = 0;
+    for (auto it = c.begin(); it != c.end(); ++it) {
+      sum += it->key;
+    }
+    bench_keep(sum);
+  }), n);
+
+  report("traverse_reverse", bench_median_ns(reps, [&] {
+    std::size_t sum = 0;
+    for (auto it = c.rbegin(); it != c.rend(); ++it) {
+      sum += it->key;
+    }
+    bench_keep(sum);
+  }), n);
+
+  report("copy", bench_median_ns(reps, [&] { other.clear(); }, [&] {
+    other = c;
+  }), n);
+
+  std::size_t const swaps = 1024;
+  bench_fill(other, n);
+  report("swap", bench_median_ns(reps, [&] {
+    for (std::size_t i = 0; i != swaps; ++i) {
+      c.swap(other);
+    }
+    bench_keep(c);
+  }), swaps);
+
+  report("clear", bench_median_ns(reps, [&] { bench_fill(c, n); }, [&] {
+    c.clear();
+  }), n);
+}
+
+template <std::size_t Bytes>
+void bench_elem_size(std::size_t n, std::size_t reps) {
+  using elem = bench_elem<Bytes>;
+  static_assert(sizeof(elem) == Bytes, "elem_bytes would not match the element measured");
+  bench_container<dllist<elem>>("dllist", n, reps);
+  bench_container<dllist<elem, dllist_pool_allocator<elem>>>("dllist_pool", n, reps);
+  bench_container<arena_dllist<elem>>("arena_dllist", n, reps);
+  bench_container<unrolled_dllist<elem>>("unrolled_dllist", n, reps);
+  bench_container<std::list<elem>>("std::list", n, reps);
+  bench_container<std::deque<elem>>("std::deque", n, reps);
+}
+
+int main()
+{
+  bench_header(std::cout);
+  for (std::size_t n : { std::size_t{1} << 10, std::size_t{1} << 14, std::size_t{1} << 18 }) {
+    std::size_t const reps = n < (std::size_t{1} << 18) ? 11 : 5;
+    bench_elem_size<8>(n, reps);
+    bench_elem_size<64>(n, reps);
+    bench_elem_size<256>(n, reps);
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+// Traversal cost per element of each xorptr_traits encoding.
+//
+// Nodes are laid out in one array and linked in address order so that the
+// measurement is dominated by the link decoding, not by cache misses.
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "xorptr.hxx"
+#include "bench.hxx"
+
+template <typename Encoding>
+struct bench_node {
+  xorptr<bench_node, Encoding> link;
+  std::size_t value;
+};
+
+template <typename Encoding>
+void bench_traversal(char const* name, std::size_t n, std::size_t reps) {
+  using node = bench_node<Encoding>;
+  using link_type = xorptr<node, Encoding>;
+
+  // nodes[0] and nodes[n + 1] are the end markers...
+  std::vector<node> nodes(n + 2);
+  for (std::size_t i = 1; i <= n; ++i) {
+    nodes[i].link = link_type(&nodes[i - 1], &nodes[i + 1]);
+    nodes[i].value = i;
+  }
+  node* const first = &nodes[1];
+  node* const last = &nodes[n];
+  node* const head = &nodes[0];
+  node* const tail = &nodes[n + 1];
+
+  auto fwd = bench_median_ns(reps, [&] {
+    std::size_t sum = 0;
+    node* prev = head;
+    node* cur = first;
+    while (cur != tail) {
+      sum += cur->value;
+      node* next = cur->link ^ prev;
+      prev = cur;
+      cur = next;
+    }
+    bench_keep(sum);
+  });
+  bench_report(std::cout, "xorptr", "traverse_forward", name, sizeof(node), n, 1, fwd / n);
+
+  auto rev = bench_median_ns(reps, [&] {
+    std::size_t sum = 0;
+    node* prev = tail;
+    node* cur = last;
+    while (cur != head) {
+      sum += cur->value;
+      node* next = cur->link ^ prev;
+      prev = cur;
+      cur = next;
+    }
+    bench_keep(sum);
+  });
+  bench_report(std::cout, "xorptr", "traverse_reverse", name, sizeof(node), n, 1, rev / n);
+}
+
+int main()
+{
+  bench_header(std::cout);
+  for (std::size_t n : { std::size_t{1} << 10, std::size_t{1} << 16, std::size_t{1} << 20 }) {
+    bench_traversal<xorptr_uintptr_encoding>("uintptr", n, 21);
+    bench_traversal<xorptr_bytewise_encoding>("bytewise", n, 21);
+  }
+  return 0;
+}
@@ -0,0 +1,928 @@
+// The code here is to implement an XOR-encoded doubly-linked list whose
+// nodes live in one relocatable arena and are linked by 32-bit indices.
+
+#ifndef ARENA_DLLIST_HXX
+#define ARENA_DLLIST_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xorptr.hxx"
+
+template <typename T>
+class arena_dllist_node;        // arena list node type
+
+template <typename T, typename Alloc = std::allocator<T>>
+class arena_dllist;             // arena list container type
+
+template <typename T>
+class arena_dllist_iter;        // arena list iterator type
+
+template <typename T>
+class arena_dllist_citer;       // arena list const_iterator type
+
+//===========================================================================
+//
+// arena_dllist_node<T>
+//
+// A node is a 32-bit XOR link followed by raw storage for one T. The link
+// holds prev ^ next, where prev and next are indices into the arena (see
+// xorptr_index32_encoding). For a node on the free list the link holds
+// the index of the next free node instead.
+//
+template <typename T>
+class arena_dllist_node final {
+public:
+  using traits_type = xorptr_traits<arena_dllist_node, xorptr_index32_encoding>;
+  using index_type = typename traits_type::pointer_type;
+
+private:
+  typename traits_type::xorptr_type xorptr_;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type datum_;
+
+public:
+  index_type nextptr(index_type prev) const {
+    return traits_type::extract(xorptr_, prev);
+  }
+
+  // As for dllist_node_ptr_only<T>::updateptr(): xorptr_ ^ old ^ new...
+  void updateptr(index_type oldptr, index_type newptr) {
+    xorptr_ = traits_type::create(traits_type::extract(xorptr_, oldptr), newptr);
+  }
+
+  void setptr(index_type ptr1, index_type ptr2) {
+    xorptr_ = traits_type::create(ptr1, ptr2);
+  }
+
+  T& datum() {
+    return *reinterpret_cast<T*>(&datum_);
+  }
+
+  T const& datum() const {
+    return *reinterpret_cast<T const*>(&datum_);
+  }
+};
+
+//===========================================================================
+//
+// arena_dllist_image_header
+//
+// image() writes this header followed by the arena's nodes [0, used).
+// Every link is an index, so the image is valid at any address.
+//
+struct arena_dllist_image_header {
+  char magic[8];                // "DLARENA\0"
+  std::uint32_t node_size;      // sizeof(arena_dllist_node<T>)
+  std::uint32_t size;           // number of elements
+  std::uint32_t used;           // number of nodes in the image
+  std::uint32_t free;           // head of the free list, 0 if none
+};
+
+//===========================================================================
+//
+// arena_dllist<T, Alloc>
+//
+// An XOR-encoded doubly-linked list whose nodes are all held in one array,
+// the arena, obtained from Alloc (rebound to arena_dllist_node<T>):
+//
+//   index 0      the "front" sentinel (its link is back ^ first)
+//   index 1      the "back" sentinel (its link is last ^ front)
+//   index 2...   element nodes, in any order; erased ones are kept on a
+//                free list and reused before the arena grows
+//
+// A link is the XOR of two 32-bit indices rather than two addresses, so
+// a node of a small T is half the size of a dllist_node<T>, e.g. 8 bytes
+// instead of 16 for int. Alignment padding can absorb the saving when
+// alignof(T) is 8. There is one allocation per arena rather than one per
+// node. A list holds at most 2^32 - 3 elements.
+//
+// When the arena is full it is reallocated at twice the size. The
+// elements are moved and the links are copied unchanged. Iterators hold
+// the indices of their nodes plus the address of the list's arena
+// pointer, so growth invalidates no iterators. insert and erase
+// invalidate the same iterators as in dllist<T>. swap() and moves
+// invalidate all iterators. Both are O(1) because the sentinels live in
+// the arena.
+//
+// For trivially copyable T the whole list can be copied with memcpy():
+// image() writes it to a buffer, and from_image() rebuilds it from that
+// buffer, e.g. after the buffer was written to a file or placed in shared
+// memory.
+//
+template <typename T, typename Alloc>
+class arena_dllist
+{
+private:
+  using node_type = arena_dllist_node<T>;
+  using index_type = typename node_type::index_type;
+  using node_allocator_type =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<node_type>;
+  using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+  static constexpr index_type front_index = 0;
+  static constexpr index_type back_index = 1;
+  static constexpr std::size_t max_nodes = std::numeric_limits<index_type>::max();
+
+  node_type* nodes_;              // the arena, or nullptr before first use
+  index_type size_;               // length of list
+  index_type capacity_;           // nodes in the arena
+  index_type used_;               // nodes [0, used_) have been handed out
+  index_type free_;               // first free node, 0 if none
+  node_allocator_type alloc_;     // source of the arena
+
+  node_type& at(index_type i) {
+    return nodes_[i];
+  }
+
+  node_type const& at(index_type i) const {
+    return nodes_[i];
+  }
+
+  index_type first_index() const {
+    return nodes_ != nullptr ? at(front_index).nextptr(back_index) : back_index;
+  }
+
+  index_type last_index() const {
+    return nodes_ != nullptr ? at(back_index).nextptr(front_index) : front_index;
+  }
+
+  // Enable the iterator-range overloads only for iterator types...
+  template <typename InIter>
+  using enable_if_iterator = typename std::enable_if<
+    !std::is_integral<InIter>::value,
+    typename std::iterator_traits<InIter>::iterator_category
+  >::type;
+
+  // Destroy the elements of the list held in the arena nodes...
+  static void destroy_data(node_type*, std::true_type) {
+  }
+
+  static void destroy_data(node_type* nodes, std::false_type) {
+    index_type prev = front_index;
+    index_type cur = nodes[front_index].nextptr(back_index);
+    while (cur != back_index) {
+      index_type next = nodes[cur].nextptr(prev);
+      nodes[cur].datum().~T();
+      prev = cur;
+      cur = next;
+    }
+  }
+
+  // copy_nodes(dst, src, used, construct) copies the links of the nodes
+  // [0, used) of src to dst and constructs each element of dst from the one
+  // at the same index of src with construct(address, element). If that
+  // throws, the elements constructed so far are destroyed again.
+  template <typename Construct>
+  static void copy_nodes(node_type* dst, node_type* src, index_type used, Construct, std::true_type) {
+    std::memcpy(static_cast<void*>(dst), static_cast<void const*>(src), used * sizeof(node_type));
+  }
+
+  template <typename Construct>
+  static void copy_nodes(node_type* dst, node_type* src, index_type used, Construct construct, std::false_type) {
+    for (index_type i = 0; i != used; ++i) {
+      dst[i].setptr(src[i].nextptr(0), 0);
+    }
+    index_type prev = front_index;
+    index_type cur = src[front_index].nextptr(back_index);
+    try {
+      while (cur != back_index) {
+        construct(static_cast<void*>(&dst[cur].datum()), src[cur].datum());
+        index_type next = src[cur].nextptr(prev);
+        prev = cur;
+        cur = next;
+      }
+    } catch (...) {
+      index_type failed = cur;
+      prev = front_index;
+      cur = src[front_index].nextptr(back_index);
+      while (cur != failed) {
+        dst[cur].datum().~T();
+        index_type next = src[cur].nextptr(prev);
+        prev = cur;
+        cur = next;
+      }
+      throw;
+    }
+  }
+
+  // Make room for at least n nodes. A new arena starts with the two
+  // sentinels; an existing one is moved into a bigger array.
+  void grow(std::size_t n) {
+    if (n > max_nodes) {
+      throw std::length_error("arena_dllist: too many nodes");
+    }
+    std::size_t cap = std::min(max_nodes, std::max({ n, std::size_t{capacity_} * 2, std::size_t{16} }));
+    node_type* p = node_alloc_traits::allocate(alloc_, cap);
+
+    if (nodes_ == nullptr) {
+      p[front_index].setptr(back_index, back_index);
+      p[back_index].setptr(front_index, front_index);
+      used_ = 2;
+    } else {
+      try {
+        copy_nodes(p, nodes_, used_, [](void* where, T& value) {
+          ::new (where) T(std::move_if_noexcept(value));
+        }, std::is_trivially_copyable<T>{});
+      } catch (...) {
+        node_alloc_traits::deallocate(alloc_, p, cap);
+        throw;
+      }
+      destroy_data(nodes_, std::is_trivially_destructible<T>{});
+      node_alloc_traits::deallocate(alloc_, nodes_, capacity_);
+    }
+    nodes_ = p;
+    capacity_ = static_cast<index_type>(cap);
+  }
+
+  // Take a node off the free list, or the next unused one...
+  index_type acquire_node() {
+    if (free_ != 0) {
+      index_type i = free_;
+      free_ = at(i).nextptr(0);
+      return i;
+    }
+    if (nodes_ == nullptr || used_ == capacity_) {
+      grow(std::size_t{used_} + 1);
+    }
+    return used_++;
+  }
+
+  void release_node(index_type i) {
+    at(i).setptr(free_, 0);
+    free_ = i;
+  }
+
+  void free_arena() {
+    if (nodes_ != nullptr) {
+      destroy_data(nodes_, std::is_trivially_destructible<T>{});
+      node_alloc_traits::deallocate(alloc_, nodes_, capacity_);
+    }
+    nodes_ = nullptr;
+    size_ = capacity_ = used_ = free_ = 0;
+  }
+
+  // check_links() walks the links of an arena read by from_image() and
+  // throws std::invalid_argument unless they describe a list: the walk
+  // from front to back stays within [2, used_), visits no node twice and
+  // finds exactly size_ elements, and the free list stays within
+  // [2, used_) and shares no node with the list. O(used_).
+  void check_links() const {
+    auto bad = [] {
+      throw std::invalid_argument("arena_dllist image: corrupt links");
+    };
+    std::vector<bool> seen(used_);
+
+    index_type prev = front_index;
+    index_type cur = at(front_index).nextptr(back_index);
+    index_type n = 0;
+    while (cur != back_index) {
+      if (cur < 2 || cur >= used_ || seen[cur] || n == size_) {
+        bad();
+      }
+      seen[cur] = true;
+      ++n;
+      index_type next = at(cur).nextptr(prev);
+      prev = cur;
+      cur = next;
+    }
+    if (n != size_ || at(back_index).nextptr(prev) != front_index) {
+      bad();
+    }
+
+    for (index_type i = free_; i != 0; i = at(i).nextptr(0)) {
+      if (i < 2 || i >= used_ || seen[i]) {
+        bad();
+      }
+      seen[i] = true;
+    }
+  }
+
+  void swap_allocators(arena_dllist& l, std::true_type) {
+    using std::swap;
+    swap(alloc_, l.alloc_);
+  }
+
+  void swap_allocators(arena_dllist&, std::false_type) {
+  }
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+
+  using reference = value_type&;
+  using const_reference = value_type const&;
+
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+  using iterator = arena_dllist_iter<T>;
+  using const_iterator = arena_dllist_citer<T>;
+
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  // Default constructor; the arena is only allocated on first insert...
+  arena_dllist() :
+    nodes_(nullptr), size_(0), capacity_(0), used_(0), free_(0), alloc_() {}
+
+  explicit arena_dllist(allocator_type const& a) :
+    nodes_(nullptr), size_(0), capacity_(0), used_(0), free_(0), alloc_(a) {}
+
+  arena_dllist(size_type n, T const& value = T{}) : arena_dllist{} {
+    reserve(n);
+    std::fill_n(std::back_inserter(*this), n, value);
+  }
+
+  arena_dllist(std::initializer_list<T> il) : arena_dllist{} {
+    reserve(il.size());
+    std::copy(il.begin(), il.end(), std::back_inserter(*this));
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  arena_dllist(InIter const& first, InIter const& last) : arena_dllist{} {
+    std::copy(first, last, std::back_inserter(*this));
+  }
+
+  // The copy has the same layout (and free list) as l, node for node...
+  arena_dllist(arena_dllist const& l) :
+    arena_dllist{allocator_type(node_alloc_traits::select_on_container_copy_construction(l.alloc_))}
+  {
+    if (l.nodes_ == nullptr) {
+      return;
+    }
+    nodes_ = node_alloc_traits::allocate(alloc_, l.used_);
+    try {
+      copy_nodes(nodes_, l.nodes_, l.used_, [](void* where, T const& value) {
+        ::new (where) T(value);
+      }, std::is_trivially_copyable<T>{});
+    } catch (...) {
+      node_alloc_traits::deallocate(alloc_, nodes_, l.used_);
+      nodes_ = nullptr;
+      throw;
+    }
+    size_ = l.size_;
+    capacity_ = used_ = l.used_;
+    free_ = l.free_;
+  }
+
+  arena_dllist(arena_dllist&& l) :
+    arena_dllist{}
+  {
+    swap(l);
+  }
+
+  ~arena_dllist() {
+    free_arena();
+  }
+
+  arena_dllist& operator =(arena_dllist const& l) {
+    arena_dllist tmp(l);
+    this->swap(tmp);
+    return *this;
+  }
+
+  arena_dllist& operator =(arena_dllist&& l) {
+    arena_dllist tmp(std::move(l));
+    this->swap(tmp);
+    return *this;
+  }
+
+  void assign(std::initializer_list<T> il) {
+    arena_dllist tmp(il);
+    this->swap(tmp);
+  }
+
+  void assign(size_type n, value_type const& value) {
+    arena_dllist tmp(n, value);
+    this->swap(tmp);
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  void assign(InIter const& first, InIter const& last) {
+    arena_dllist tmp(first, last);
+    this->swap(tmp);
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(alloc_);
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_type size() const {
+    return size_;
+  }
+
+  size_type max_size() const {
+    return max_nodes - 2;
+  }
+
+  // capacity() is the number of elements the arena holds without growing...
+  size_type capacity() const {
+    return capacity_ != 0 ? capacity_ - 2 : 0;
+  }
+
+  void reserve(size_type n) {
+    if (n > max_size()) {
+      throw std::length_error("arena_dllist: too many nodes");
+    }
+    if (n != 0 && n + 2 > capacity_) {
+      grow(n + 2);
+    }
+  }
+
+  reference front() {
+    return at(first_index()).datum();
+  }
+
+  const_reference front() const {
+    return at(first_index()).datum();
+  }
+
+  reference back() {
+    return at(last_index()).datum();
+  }
+
+  const_reference back() const {
+    return at(last_index()).datum();
+  }
+
+  iterator begin() {
+    return iterator(&nodes_, front_index, first_index());
+  }
+
+  iterator end() {
+    return iterator(&nodes_, last_index(), back_index);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(&nodes_, front_index, first_index());
+  }
+
+  const_iterator end() const {
+    return const_iterator(&nodes_, last_index(), back_index);
+  }
+
+  const_iterator cbegin() const {
+    return begin();
+  }
+
+  const_iterator cend() const {
+    return end();
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(this->end());
+  }
+
+  reverse_iterator rend() {
+    return reverse_iterator(this->begin());
+  }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(this->end());
+  }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(this->begin());
+  }
+
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(this->cend());
+  }
+
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(this->cbegin());
+  }
+
+  // clear() destroys all elements but keeps the arena for reuse
+  void clear() {
+    if (nodes_ == nullptr) {
+      return;
+    }
+    destroy_data(nodes_, std::is_trivially_destructible<T>{});
+    at(front_index).setptr(back_index, back_index);
+    at(back_index).setptr(front_index, front_index);
+    size_ = 0;
+    used_ = 2;
+    free_ = 0;
+  }
+
+  // The sentinels are inside the arena, so swapping lists only swaps the
+  // arena pointers and counters.
+  void swap(arena_dllist& l) {
+    std::swap(nodes_, l.nodes_);
+    std::swap(size_, l.size_);
+    std::swap(capacity_, l.capacity_);
+    std::swap(used_, l.used_);
+    std::swap(free_, l.free_);
+    swap_allocators(l, typename node_alloc_traits::propagate_on_container_swap{});
+  }
+
+  void push_front(value_type const& v) {
+    emplace(begin(), v);
+  }
+
+  void push_front(value_type&& v) {
+    emplace(begin(), std::move(v));
+  }
+
+  void pop_front() {
+    erase(begin());
+  }
+
+  void push_back(value_type const& v) {
+    emplace(end(), v);
+  }
+
+  void push_back(value_type&& v) {
+    emplace(end(), std::move(v));
+  }
+
+  void pop_back() {
+    erase(--end());
+  }
+
+  // The value is constructed before a node is taken, since args may refer
+  // to an element that would be moved if the arena had to grow.
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    if (size_ == max_size()) {
+      throw std::length_error("arena_dllist: too many nodes");
+    }
+    T value(std::forward<Args>(args)...);
+
+    index_type p = pos.prev_;
+    index_type q = pos.cur_;
+    index_type n = acquire_node();
+    try {
+      ::new (static_cast<void*>(&at(n).datum())) T(std::move(value));
+    } catch (...) {
+      release_node(n);
+      throw;
+    }
+
+    //    START: p, q
+    //   RESULT: p, n, q
+    at(n).setptr(p, q);
+    at(p).updateptr(q, n);
+    at(q).updateptr(p, n);
+    ++size_;
+    return iterator(&nodes_, p, n);
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    this->emplace(begin(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    this->emplace(end(), std::forward<Args>(args)...);
+  }
+
+  iterator insert(const_iterator pos, value_type const& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, value_type&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // The multi-element inserts return an iterator to the first inserted
+  // element (or pos if nothing was inserted)...
+  iterator insert(const_iterator pos, size_type n, value_type const& value) {
+    iterator result(&nodes_, pos.prev_, pos.cur_);
+    if (n == 0) {
+      return result;
+    }
+    result = emplace(pos, value);
+    // Copy from the first new element: value may refer into the arena,
+    // which can move when it grows (emplace copies its argument first).
+    const_iterator next = result;
+    for (++next; --n != 0; ++next) {
+      next = emplace(next, *result);
+    }
+    return result;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> il) {
+    return insert(pos, il.begin(), il.end());
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  iterator insert(const_iterator pos, InIter first, InIter const& last) {
+    iterator result(&nodes_, pos.prev_, pos.cur_);
+    if (first == last) {
+      return result;
+    }
+    result = emplace(pos, *first);
+    const_iterator next = result;
+    for (++first, ++next; first != last; ++first, ++next) {
+      next = emplace(next, *first);
+    }
+    return result;
+  }
+
+  iterator erase(const_iterator pos) {
+    index_type p = pos.prev_;
+    index_type c = pos.cur_;
+    index_type n = at(c).nextptr(p);
+
+    //    START: p, c, n
+    //   RESULT: p, n
+    at(p).updateptr(c, n);
+    at(n).updateptr(c, p);
+    at(c).datum().~T();
+    release_node(c);
+    --size_;
+    return iterator(&nodes_, p, n);
+  }
+
+  iterator erase(const_iterator first, const_iterator const& last) {
+    iterator i(&nodes_, first.prev_, first.cur_);
+    while (i != last) {
+      i = erase(i);
+    }
+    return i;
+  }
+
+  // image_size() is the number of bytes image() writes...
+  size_type image_size() const {
+    return sizeof(arena_dllist_image_header) + std::size_t{used_} * sizeof(node_type);
+  }
+
+  // image(dest) copies the list, i.e., its arena and counters, to the
+  // image_size() bytes at dest. Only for trivially copyable T.
+  void image(void* dest) const {
+    static_assert(std::is_trivially_copyable<T>::value,
+      "arena_dllist images require a trivially copyable T");
+
+    arena_dllist_image_header h;
+    std::memcpy(h.magic, "DLARENA\0", sizeof h.magic);
+    h.node_size = sizeof(node_type);
+    h.size = size_;
+    h.used = used_;
+    h.free = free_;
+
+    auto bytes = static_cast<unsigned char*>(dest);
+    std::memcpy(bytes, &h, sizeof h);
+    if (used_ != 0) {
+      std::memcpy(bytes + sizeof h, static_cast<void const*>(nodes_), used_ * sizeof(node_type));
+    }
+  }
+
+  // from_image(src, n, a) rebuilds a list from an image of n bytes with a
+  // single allocation and memcpy(). The image must have been written by
+  // image() for the same T. The header and every link are validated
+  // (see check_links()), so a malformed or corrupted image throws
+  // std::invalid_argument rather than yielding a list that reads or writes
+  // outside its arena.
+  static arena_dllist from_image(void const* src, size_type n, allocator_type const& a = allocator_type{}) {
+    static_assert(std::is_trivially_copyable<T>::value,
+      "arena_dllist images require a trivially copyable T");
+
+    arena_dllist_image_header h;
+    if (n < sizeof h) {
+      throw std::invalid_argument("arena_dllist image: truncated header");
+    }
+    std::memcpy(&h, src, sizeof h);
+    if (std::memcmp(h.magic, "DLARENA\0", sizeof h.magic) != 0) {
+      throw std::invalid_argument("arena_dllist image: bad magic");
+    }
+    if (h.node_size != sizeof(node_type)) {
+      throw std::invalid_argument("arena_dllist image: node size mismatch");
+    }
+    // An empty image (used == 0) has no arena at all; any other needs the
+    // two sentinels plus size element nodes...
+    bool const empty = h.used == 0 && h.size == 0 && h.free == 0;
+    if (!empty && (std::uint64_t{h.size} + 2 > h.used || h.free >= h.used)) {
+      throw std::invalid_argument("arena_dllist image: inconsistent header");
+    }
+    if ((n - sizeof h) / sizeof(node_type) < h.used) {
+      throw std::invalid_argument("arena_dllist image: truncated nodes");
+    }
+
+    arena_dllist l(a);
+    if (h.used != 0) {
+      l.nodes_ = node_alloc_traits::allocate(l.alloc_, h.used);
+      std::memcpy(
+        static_cast<void*>(l.nodes_),
+        static_cast<unsigned char const*>(src) + sizeof h,
+        h.used * sizeof(node_type)
+      );
+      l.size_ = h.size;
+      l.capacity_ = l.used_ = h.used;
+      l.free_ = h.free;
+      l.check_links();
+    }
+    return l;
+  }
+};
+
+template <typename T, typename Alloc>
+constexpr typename arena_dllist<T, Alloc>::index_type arena_dllist<T, Alloc>::front_index;
+
+template <typename T, typename Alloc>
+constexpr typename arena_dllist<T, Alloc>::index_type arena_dllist<T, Alloc>::back_index;
+
+template <typename T, typename Alloc>
+constexpr std::size_t arena_dllist<T, Alloc>::max_nodes;
+
+//===========================================================================
+
+template <typename T, typename Alloc>
+inline void swap(arena_dllist<T, Alloc>& a, arena_dllist<T, Alloc>& b)
+{
+  a.swap(b);
+}
+
+template <typename T, typename Alloc>
+inline bool operator ==(arena_dllist<T, Alloc> const& a, arena_dllist<T, Alloc> const& b)
+{
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, typename Alloc>
+inline bool operator !=(arena_dllist<T, Alloc> const& a, arena_dllist<T, Alloc> const& b)
+{
+  return !(a == b);
+}
+
+//===========================================================================
+//
+// arena_dllist_iter<T>
+//
+// Like dllist_iter<T>, the iterator remembers the previous node to decode
+// the XOR link. Nodes are named by index, and the arena is reached through
+// the list's own arena pointer so that the iterator survives growth.
+//
+template <typename T>
+class arena_dllist_iter : public std::iterator<std::bidirectional_iterator_tag, T, std::ptrdiff_t, T*, T&> {
+private:
+  template <typename, typename> friend class arena_dllist;
+  friend class arena_dllist_citer<T>;
+
+  using node_type = arena_dllist_node<T>;
+  using index_type = typename node_type::index_type;
+
+  node_type* const* arena_;   // The owning list's arena pointer
+  index_type prev_;           // Used to compute next node index
+  index_type cur_;            // Current node
+
+  node_type& node(index_type i) const {
+    return (*arena_)[i];
+  }
+
+public:
+  arena_dllist_iter() :
+    arena_{nullptr}, prev_{0}, cur_{0} {}
+
+  arena_dllist_iter(node_type* const* arena, index_type prev, index_type cur) :
+    arena_{arena}, prev_{prev}, cur_{cur} {}
+
+  bool operator ==(arena_dllist_iter const& i) const {
+    return cur_ == i.cur_;
+  }
+
+  bool operator !=(arena_dllist_iter const& i) const {
+    return !(operator==(i));
+  }
+
+  T& operator *() const {
+    return node(cur_).datum();
+  }
+
+  T* operator ->() const {
+    return &node(cur_).datum();
+  }
+
+  arena_dllist_iter& operator ++() {
+    auto next = node(cur_).nextptr(prev_);
+    prev_ = cur_;
+    cur_ = next;
+    return *this;
+  }
+
+  arena_dllist_iter operator ++(int) {
+    arena_dllist_iter tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  arena_dllist_iter& operator --() {
+    auto prev_prev = node(prev_).nextptr(cur_);
+    cur_ = prev_;
+    prev_ = prev_prev;
+    return *this;
+  }
+
+  arena_dllist_iter operator --(int) {
+    arena_dllist_iter tmp(*this);
+    operator--();
+    return tmp;
+  }
+};
+
+//===========================================================================
+//
+// arena_dllist_citer<T>
+//
+template <typename T>
+class arena_dllist_citer : public std::iterator<std::bidirectional_iterator_tag, T const, std::ptrdiff_t, T const*, T const&> {
+private:
+  template <typename, typename> friend class arena_dllist;
+
+  using node_type = arena_dllist_node<T>;
+  using index_type = typename node_type::index_type;
+
+  node_type* const* arena_;
+  index_type prev_;
+  index_type cur_;
+
+  node_type const& node(index_type i) const {
+    return (*arena_)[i];
+  }
+
+public:
+  arena_dllist_citer() :
+    arena_{nullptr}, prev_{0}, cur_{0} {}
+
+  arena_dllist_citer(node_type* const* arena, index_type prev, index_type cur) :
+    arena_{arena}, prev_{prev}, cur_{cur} {}
+
+  arena_dllist_citer(arena_dllist_iter<T> const& i) :
+    arena_{i.arena_}, prev_{i.prev_}, cur_{i.cur_} {}
+
+  bool operator ==(arena_dllist_citer const& i) const {
+    return cur_ == i.cur_;
+  }
+
+  bool operator !=(arena_dllist_citer const& i) const {
+    return !(operator==(i));
+  }
+
+  T const& operator *() const {
+    return node(cur_).datum();
+  }
+
+  T const* operator ->() const {
+    return &node(cur_).datum();
+  }
+
+  arena_dllist_citer& operator ++() {
+    auto next = node(cur_).nextptr(prev_);
+    prev_ = cur_;
+    cur_ = next;
+    return *this;
+  }
+
+  arena_dllist_citer operator ++(int) {
+    arena_dllist_citer tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  arena_dllist_citer& operator --() {
+    auto prev_prev = node(prev_).nextptr(cur_);
+    cur_ = prev_;
+    prev_ = prev_prev;
+    return *this;
+  }
+
+  arena_dllist_citer operator --(int) {
+    arena_dllist_citer tmp(*this);
+    operator--();
+    return tmp;
+  }
+};
+
+template <typename T>
+inline bool operator ==(arena_dllist_iter<T> const& i, arena_dllist_citer<T> const& j)
+{
+  return j == i;
+}
+
+template <typename T>
+inline bool operator !=(arena_dllist_iter<T> const& i, arena_dllist_citer<T> const& j)
+{
+  return j != i;
+}
+
+#endif // #ifndef ARENA_DLLIST_HXX
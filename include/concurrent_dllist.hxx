@@ -0,0 +1,199 @@
+// The code here is to implement a multi-producer/single-consumer queue on
+// top of the XOR-encoded doubly-linked list nodes.
+
+#ifndef CONCURRENT_DLLIST_HXX
+#define CONCURRENT_DLLIST_HXX
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "dllist.hxx"
+
+#if !defined __GNUC__
+#error "concurrent_dllist requires the __atomic builtins (GCC or Clang)"
+#endif
+
+//===========================================================================
+//
+// concurrent_dllist<T, Alloc>
+//
+// A lock-free MPSC queue: any number of threads may push_back() while one
+// thread at a time calls try_pop_front(). It uses the same node type
+// (dllist_node<T>) and sentinel pair as dllist<T>:
+//
+//   front_  the consumer's anchor; front_'s xorptr_ is nullptr ^ first.
+//   back_   a stub node that keeps the queue non-empty. It starts out as
+//           the only node and is re-enqueued whenever the consumer has to
+//           take the last node.
+//
+// A node's xorptr_ is prev ^ next where next is nullptr until a successor
+// is linked. push_back() swings tail_ to the new node and then XORs the
+// new node into the old tail's link (a single fetch_xor). When the
+// consumer unlinks the first node it XORs &front_ in place of that node
+// into the second node's link. Both updates touch different halves of
+// the same word, and XOR commutes, so they never conflict.
+//
+// Memory reclamation: the last thing a producer does to a node other than
+// its own is the fetch_xor that links its successor. The consumer removes
+// a node only once it has seen that successor, so no producer can still
+// hold a reference to it. That hand-off makes it safe to free the node
+// immediately; hazard pointers or epochs are not needed with a single
+// consumer.
+//
+// Like other intrusive MPSC queues, try_pop_front() can briefly report
+// "nothing available" while a producer is between its two steps.
+//
+// Alloc must be safe to call from several threads at once (as
+// std::allocator is).
+//
+template <typename T, typename Alloc = std::allocator<T>>
+class concurrent_dllist
+{
+private:
+  using node_type = dllist_node<T>;
+  using link_type = dllist_node_ptr_only<T>;
+  using node_allocator_type =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<node_type>;
+  using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
+  static_assert(
+    std::is_same<typename link_type::xorptr_type::encoding_type, xorptr_uintptr_encoding>::value,
+    "concurrent_dllist requires xorptr_uintptr_encoding"
+  );
+
+  // Consumer side...
+  link_type front_;                   // anchor, touched by the consumer only
+  link_type back_;                    // stub node
+  node_allocator_type alloc_;
+
+  // Producer side, on its own cache line...
+  alignas(64) std::atomic<link_type*> tail_;
+
+  template <typename... Args>
+  node_type* create_node(Args&&... args) {
+    node_type* p = node_alloc_traits::allocate(alloc_, 1);
+    try {
+      node_alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+    } catch (...) {
+      node_alloc_traits::deallocate(alloc_, p, 1);
+      throw;
+    }
+    return p;
+  }
+
+  void destroy_node(link_type* p) {
+    node_type* n = &p->to_node();
+    node_alloc_traits::destroy(alloc_, n);
+    node_alloc_traits::deallocate(alloc_, n, 1);
+  }
+
+  // Append n, whose xorptr_ must be nullptr ^ nullptr...
+  void enqueue(link_type* n) {
+    link_type* prev = tail_.exchange(n, std::memory_order_acq_rel);
+    n->atomic_updateptr(nullptr, prev);
+    prev->atomic_updateptr(nullptr, n);     // publishes n to the consumer
+  }
+
+  // Unlink first, the node after front_, whose successor is next...
+  void unlink_first(link_type* first, link_type* next) {
+    front_.setptr(nullptr, next);
+    next->atomic_updateptr(first, &front_);
+  }
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+  using size_type = std::size_t;
+
+  concurrent_dllist() :
+    front_(nullptr, &back_), back_(&front_, nullptr), alloc_(), tail_(&back_) {}
+
+  explicit concurrent_dllist(allocator_type const& a) :
+    front_(nullptr, &back_), back_(&front_, nullptr), alloc_(a), tail_(&back_) {}
+
+  // Prohibitions...
+  concurrent_dllist(concurrent_dllist const&) = delete;
+  concurrent_dllist& operator =(concurrent_dllist const&) = delete;
+
+  // No other thread may use the queue while it is destroyed.
+  ~concurrent_dllist() {
+    link_type* prev = &front_;
+    link_type* cur = front_.nextptr(nullptr);
+    while (cur != nullptr) {
+      link_type* next = cur->nextptr(prev);
+      if (cur != &back_) {
+        destroy_node(cur);
+      }
+      prev = cur;
+      cur = next;
+    }
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(alloc_);
+  }
+
+  // Producer operations; safe to call from any number of threads...
+  void push_back(value_type const& v) {
+    enqueue(create_node(v));
+  }
+
+  void push_back(value_type&& v) {
+    enqueue(create_node(std::move(v)));
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    enqueue(create_node(T(std::forward<Args>(args)...)));
+  }
+
+  // Consumer operations; only one thread at a time...
+  //
+  // try_pop_front(v) moves the front element into v and returns true, or
+  // returns false if no element is available.
+  bool try_pop_front(value_type& v) {
+    link_type* first = front_.nextptr(nullptr);
+    link_type* next = first->atomic_nextptr(&front_);
+
+    if (first == &back_) {
+      if (next == nullptr) {
+        return false;                       // empty
+      }
+      // Skip the stub; it is re-enqueued when the queue next drains...
+      unlink_first(first, next);
+      first = next;
+      next = first->atomic_nextptr(&front_);
+    }
+
+    if (next == nullptr) {
+      // first is the last node, so a producer may be about to link a node
+      // behind it. Unless it is also the tail (i.e., no push is under way)
+      // it cannot be taken yet. Otherwise put the stub behind it.
+      if (tail_.load(std::memory_order_acquire) != first) {
+        return false;
+      }
+      back_.atomic_setptr(nullptr, nullptr);
+      enqueue(&back_);
+      next = first->atomic_nextptr(&front_);
+      if (next == nullptr) {
+        return false;                       // a push got in first
+      }
+    }
+
+    v = std::move(first->to_node().datum());
+    unlink_first(first, next);
+    destroy_node(first);
+    return true;
+  }
+
+  // true if no element is visible to the consumer
+  bool empty() const {
+    link_type const* first = front_.nextptr(static_cast<link_type const*>(nullptr));
+    return first == &back_ &&
+      back_.atomic_nextptr(const_cast<link_type*>(&front_)) == nullptr;
+  }
+};
+
+#endif // #ifndef CONCURRENT_DLLIST_HXX
@@ -4,23 +4,29 @@
 #define DLLIST_HXX
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <limits>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 #include "xorptr.hxx"
 
 template <typename T>
 class dllist_node;      // doubly-linked list node type
 
-template <typename T>
+struct dllist_no_stats; // default (empty) statistics policy
+
+template <typename T, typename Alloc = std::allocator<T>, typename Stats = dllist_no_stats>
 class dllist;           // doubly-linked list container type
 
-template <typename T>
+template <typename T, typename Stats = dllist_no_stats>
 class dllist_iter;      // doubly-linked list iterator type
 
-template <typename T>
+template <typename T, typename Stats = dllist_no_stats>
 class dllist_citer;     // doubly-linked list const_iterator type
 
 /* dllist_node_ptr_only<T> is a class template which represents
@@ -30,6 +36,12 @@ the "pointer" part (i.e., xorptr_). The remainder of
  from dllist_node_ptr_only<T> to be a complete node.
  By defining a node in two parts allows the creation
  of sentinel nodes 
+
+ The link is an xorptr<> with xorptr_default_encoding, so every dllist<T>
+ in a program uses the same encoding: uintptr_t by default, byte-wise if
+ CXX_XOR_PROJECT_USE_REINTERPRET_CAST is defined. There is no per-list
+ Encoding parameter. xorptr_index32_encoding needs an arena and is only
+ used by arena_dllist<T>.
 */
 template <typename T>
 class dllist_node_ptr_only {
@@ -128,6 +140,22 @@ public:
     xorptr_ = xorptr_type{ ptr1, ptr2 };
   }
 
+  // Atomic counterparts of nextptr(), updateptr() and setptr() for links
+  // that are read and written by several threads (see concurrent_dllist<T>).
+  // Because XOR commutes, two threads may atomic_updateptr() the two
+  // halves of the same link concurrently.
+  dllist_node_ptr_only* atomic_nextptr(dllist_node_ptr_only* prev) const {
+    return xorptr_.atomic_extract(prev);
+  }
+
+  void atomic_updateptr(dllist_node_ptr_only* oldptr, dllist_node_ptr_only* newptr) {
+    xorptr_.atomic_update(oldptr, newptr);
+  }
+
+  void atomic_setptr(dllist_node_ptr_only* ptr1, dllist_node_ptr_only* ptr2) {
+    xorptr_.atomic_store(ptr1, ptr2);
+  }
+
   /* insert(prev, before, new_node) has arguments that appear in
        the ORDER that they are intended to be in the linked list.
        Moreover, insert() returns the node pointer that is after
@@ -290,23 +318,512 @@ inline void swap(dllist_node<T>& a, dllist_node<T>& b) {
 
 //===========================================================================
 
+// dllist_alloc_has_release<Alloc> detects node allocators that own their
+// memory in slabs (e.g., dllist_pool_allocator<T>). Such an allocator
+// provides unique() and release() so that clear() can hand back every node
+// at once instead of deallocating the list node by node, and has_free() so
+// that bulk builds reuse freed nodes before asking for a new block.
+template <typename Alloc, typename = void>
+struct dllist_alloc_has_release : std::false_type {};
+
+template <typename Alloc>
+struct dllist_alloc_has_release<Alloc,
+  decltype(std::declval<Alloc&>().release(), void())> : std::true_type {};
+
+//===========================================================================
+
+// dllist_alloc_base<Alloc> holds a list's node allocator. dllist derives
+// from it (privately) so that an empty allocator such as std::allocator<T>
+// takes no space in the list object.
+template <typename Alloc>
+class dllist_alloc_base : private Alloc {
+protected:
+  dllist_alloc_base() :
+    Alloc() {}
+
+  explicit dllist_alloc_base(Alloc const& a) :
+    Alloc(a) {}
+
+  Alloc& node_alloc() {
+    return *this;
+  }
+
+  Alloc const& node_alloc() const {
+    return *this;
+  }
+};
+
+//===========================================================================
+
+// dllist_no_stats is the default Stats policy of dllist<T, Alloc, Stats>.
+// Its hooks are empty and it has no data members. It is a base of dllist,
+// and its cursor is a base of the iterators, so it adds no space and no
+// code.
 //
-// dllist<T>
+// A Stats policy provides:
+//
+//   cursor                         held by iterators; its visit() is called
+//                                  on every ++ and --
+//   make_cursor()                  the cursor given to the list's iterators
+//   on_allocate(nodes, bytes)      nodes were obtained from the allocator
+//   on_deallocate(nodes, bytes)    nodes were given back to the allocator
+//   on_insert(n), on_erase(n)      n elements were added or removed
+//   on_transfer(to, nodes, bytes)  nodes were moved to the list whose policy
+//                                  is to (splice(), swap())
+//
+// dllist_stats.hxx provides dllist_counting_stats, which implements these
+// hooks with counters.
+struct dllist_no_stats {
+  struct cursor {
+    void visit() const {}
+  };
+
+  cursor make_cursor() const {
+    return cursor{};
+  }
+
+  void on_allocate(std::size_t, std::size_t) {}
+  void on_deallocate(std::size_t, std::size_t) {}
+  void on_insert(std::size_t) {}
+  void on_erase(std::size_t) {}
+  void on_transfer(dllist_no_stats&, std::size_t, std::size_t) {}
+};
+
+//===========================================================================
+
+//
+// dllist<T, Alloc, Stats>
 //
 // The dllist<T> type is the xor-encoded doubly-linked list sequence
 // container class. This type allows to store, erase, and access
 // elements stored within it not like std::vector<T>, std::list<T>, etc.
 //
-template <typename T>
-class dllist
+// Alloc is rebound to dllist_node<T>, so every node is obtained from (and
+// returned to) the list's allocator rather than from new/delete.
+//
+// Stats is a compile-time statistics policy (see dllist_no_stats above).
+// It is a private base so that the default, empty policy takes no space.
+// So is the node allocator, through dllist_alloc_base.
+//
+template <typename T, typename Alloc, typename Stats>
+class dllist :
+  private Stats,
+  private dllist_alloc_base<typename std::allocator_traits<Alloc>::template rebind_alloc<dllist_node<T>>>
 {
 private:
+  using node_type = dllist_node<T>;
+  using node_allocator_type =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<node_type>;
+  using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+  using alloc_base = dllist_alloc_base<node_allocator_type>;
+  using alloc_base::node_alloc;
+
   std::size_t size_;                // length of list
   dllist_node_ptr_only<T> front_;   // sentinel "front" node
   dllist_node_ptr_only<T> back_;    // sentinel "back" node
 
+  // Allocate and construct a detached node from args...
+  template <typename... Args>
+  node_type* create_node(Args&&... args) {
+    node_type* p = node_alloc_traits::allocate(node_alloc(), 1);
+    try {
+      node_alloc_traits::construct(node_alloc(), p, std::forward<Args>(args)...);
+    } catch (...) {
+      node_alloc_traits::deallocate(node_alloc(), p, 1);
+      throw;
+    }
+    count_allocate(1);
+    return p;
+  }
+
+  // Destroy and deallocate a node that has already been unlinked...
+  void destroy_node(dllist_node_ptr_only<T>* p) {
+    node_type* n = &p->to_node();
+    node_alloc_traits::destroy(node_alloc(), n);
+    node_alloc_traits::deallocate(node_alloc(), n, 1);
+    count_deallocate(1);
+  }
+
+  // Report node allocations and transfers to the Stats policy in bytes...
+  void count_allocate(std::size_t n) {
+    Stats::on_allocate(n, n * sizeof(node_type));
+  }
+
+  void count_deallocate(std::size_t n) {
+    Stats::on_deallocate(n, n * sizeof(node_type));
+  }
+
+  void count_transfer(dllist& to, std::size_t n) {
+    Stats::on_transfer(static_cast<Stats&>(to), n, n * sizeof(node_type));
+  }
+
+  // clear() for allocators without bulk release: unlink node by node.
+  void clear_nodes(std::false_type) {
+    while (!this->empty()) {
+      this->pop_back();
+    }
+  }
+
+  // clear() for slab allocators: run the element destructors (if any),
+  // then give every slab back at once. This is only done when the list is
+  // the sole user of the pool; otherwise fall back to node by node.
+  void clear_nodes(std::true_type) {
+    if (!node_alloc().unique()) {
+      clear_nodes(std::false_type{});
+      return;
+    }
+    destroy_data(std::is_trivially_destructible<T>{});
+    node_alloc().release();
+    Stats::on_erase(size_);
+    count_deallocate(size_);
+    front_.setptr(&back_, &back_);
+    back_.setptr(&front_, &front_);
+    size_ = 0;
+  }
+
+  void destroy_data(std::true_type) {
+  }
+
+  void destroy_data(std::false_type) {
+    dllist_node_ptr_only<T>* prev = &front_;
+    auto cur = front_.nextptr(&back_);
+    while (cur != &back_) {
+      auto next = cur->nextptr(prev);
+      node_alloc_traits::destroy(node_alloc(), &cur->to_node());
+      prev = cur;
+      cur = next;
+    }
+  }
+
+  void swap_allocators(dllist& l, std::true_type) {
+    using std::swap;
+    swap(node_alloc(), l.node_alloc());
+  }
+
+  void swap_allocators(dllist&, std::false_type) {
+  }
+
+  using link_type = dllist_node_ptr_only<T>;
+
+  static link_type* mutable_ptr(link_type const* p) {
+    return const_cast<link_type*>(p);
+  }
+
+  // relink(p, q, before, a, z, after) unlinks the chain a ... z, whose
+  // outer neighbours are before and after, and links it in between the
+  // adjacent nodes p and q. Only the six xorptr_ values at the two seams
+  // change, so this is O(1) whatever the length of the chain.
+  //
+  // NOTE: q must be neither a nor after (i.e., the chain must actually move).
+  static void relink(
+    link_type* p, link_type* q,
+    link_type* before, link_type* a, link_type* z, link_type* after
+  )
+  {
+    //    START: before, a, ..., z, after    and    p, q
+    //   RESULT: before, after               and    p, a, ..., z, q
+    before->updateptr(a, after);
+    after->updateptr(z, before);
+    a->updateptr(before, p);
+    z->updateptr(after, q);
+    p->updateptr(q, a);
+    q->updateptr(p, z);
+  }
+
+  // dllist_serialize() (dllist_io.hxx) walks the list with uncounted()...
+  template <typename U, typename A, typename S>
+  friend void dllist_serialize(std::ostream&, dllist<U, A, S> const&);
+
+  // uncounted(i) is a copy of i without its Stats cursor. The list steps
+  // through its own nodes with it (or with nextptr()) so that only
+  // traversal by user code counts as node visits.
+  static dllist_citer<T, Stats> uncounted(dllist_citer<T, Stats> const& i) {
+    return dllist_citer<T, Stats>(i.prevptr_, i.nodeptr_);
+  }
+
+  // Link newnode in front of pos and return an iterator to it...
+  dllist_iter<T, Stats> link_node(dllist_citer<T, Stats> pos, node_type* newnode) {
+    link_type* p = mutable_ptr(pos.prevptr_);
+    link_type* q = mutable_ptr(pos.nodeptr_);
+    link_type::insert(p->nextptr(q), p, newnode);
+    ++size_;
+    Stats::on_insert(1);
+    return dllist_iter<T, Stats>(p, newnode, this->make_cursor());
+  }
+
+  // Splice the n nodes [first, last) of l in front of pos. Nodes cannot
+  // change allocators, so if l's allocator differs from this one the
+  // elements are moved into new nodes instead.
+  void splice_nodes(
+    dllist_citer<T, Stats> pos, dllist& l,
+    dllist_citer<T, Stats> first, dllist_citer<T, Stats> last, std::size_t n
+  )
+  {
+    link_type* p = mutable_ptr(pos.prevptr_);
+    link_type* q = mutable_ptr(pos.nodeptr_);
+
+    if (this != &l && !(node_alloc() == l.node_alloc())) {
+      for (auto i = uncounted(first); i != last; ++i) {
+        auto newnode = create_node(std::move(mutable_ptr(i.nodeptr_)->to_node().datum()));
+        link_type::insert(p->nextptr(q), p, newnode);
+        p = newnode;
+        ++size_;
+        Stats::on_insert(1);
+      }
+      l.erase(
+        dllist_iter<T, Stats>(mutable_ptr(first.prevptr_), mutable_ptr(first.nodeptr_), l.make_cursor()),
+        dllist_iter<T, Stats>(mutable_ptr(last.prevptr_), mutable_ptr(last.nodeptr_), l.make_cursor())
+      );
+      return;
+    }
+
+    link_type* before = mutable_ptr(first.prevptr_);
+    link_type* a = mutable_ptr(first.nodeptr_);
+    link_type* z = mutable_ptr(last.prevptr_);
+    link_type* after = mutable_ptr(last.nodeptr_);
+
+    if (q == a || q == after) {
+      return;     // already in place
+    }
+
+    relink(p, q, before, a, z, after);
+
+    if (this != &l) {
+      l.size_ -= n;
+      size_ += n;
+      l.count_transfer(*this, n);
+    }
+  }
+
+  // A chain is a run of n detached nodes: head's xorptr_ is nullptr ^ next
+  // and tail's xorptr_ is prev ^ nullptr, so only those two links have to
+  // be patched when the chain is linked into the list.
+  struct chain {
+    link_type* head;
+    link_type* tail;
+    std::size_t n;
+  };
+
+  // Enable the iterator-range overloads only for iterator types so that,
+  // e.g., dllist<int>(6, 10) still selects the (n, value) overload.
+  template <typename InIter>
+  using enable_if_iterator = typename std::enable_if<
+    !std::is_integral<InIter>::value,
+    typename std::iterator_traits<InIter>::iterator_category
+  >::type;
+
+  // Destroy every node of a (partially built) chain...
+  void destroy_chain(chain& c) {
+    link_type* prev = nullptr;
+    link_type* cur = c.head;
+    while (cur != nullptr) {
+      auto next = cur->nextptr(prev);
+      destroy_node(cur);
+      prev = cur;
+      cur = next;
+    }
+    c = chain{ nullptr, nullptr, 0 };
+  }
+
+  // Allocate one node, construct it with construct(p) and append it to c.
+  template <typename Construct>
+  void append_node(chain& c, Construct& construct) {
+    node_type* p = node_alloc_traits::allocate(node_alloc(), 1);
+    try {
+      construct(p);
+    } catch (...) {
+      node_alloc_traits::deallocate(node_alloc(), p, 1);
+      throw;
+    }
+    count_allocate(1);
+    p->setptr(c.tail, nullptr);
+    if (c.tail != nullptr) {
+      c.tail->updateptr(nullptr, p);
+    } else {
+      c.head = p;
+    }
+    c.tail = p;
+    ++c.n;
+  }
+
+  // build_chain(n, construct) builds a chain of n nodes, constructing the
+  // i-th one with construct(p). If construct throws, everything built so
+  // far is destroyed and the list itself is untouched.
+  template <typename Construct>
+  chain build_chain(std::size_t n, Construct construct) {
+    return build_chain(n, construct, dllist_alloc_has_release<node_allocator_type>{});
+  }
+
+  // Slab allocators can take nodes back one at a time even when they were
+  // handed out as a block, so the nodes are allocated as one block and each
+  // xorptr_ is computed in the same pass that constructs the node.
+  //
+  // A block never comes from the free list, though, so the nodes freed
+  // earlier (e.g., by the previous assign(), or a slab tail) are used
+  // first, one at a time, and only the remaining nodes are allocated as one
+  // block. Otherwise every assign() or range insert() after an erase would
+  // grow the pool.
+  template <typename Construct>
+  chain build_chain(std::size_t n, Construct& construct, std::true_type) {
+    chain c{ nullptr, nullptr, 0 };
+    try {
+      while (c.n != n && node_alloc().has_free()) {
+        append_node(c, construct);
+      }
+    } catch (...) {
+      destroy_chain(c);
+      throw;
+    }
+    if (c.n == n) {
+      return c;
+    }
+
+    std::size_t m = n - c.n;
+    node_type* block;
+    try {
+      block = node_alloc_traits::allocate(node_alloc(), m);
+    } catch (...) {
+      destroy_chain(c);
+      throw;
+    }
+    std::size_t i = 0;
+    try {
+      for (; i != m; ++i) {
+        construct(block + i);
+        block[i].setptr(i != 0 ? block + i - 1 : c.tail, i + 1 != m ? block + i + 1 : nullptr);
+      }
+    } catch (...) {
+      while (i != 0) {
+        node_alloc_traits::destroy(node_alloc(), block + --i);
+      }
+      node_alloc_traits::deallocate(node_alloc(), block, m);
+      destroy_chain(c);
+      throw;
+    }
+    count_allocate(m);
+
+    // Append the block to the nodes taken from the free list...
+    if (c.tail != nullptr) {
+      c.tail->updateptr(nullptr, block);
+    } else {
+      c.head = block;
+    }
+    c.tail = block + m - 1;
+    c.n = n;
+    return c;
+  }
+
+  // Other allocators must get back exactly what they handed out, so the
+  // nodes are allocated one by one (but still linked in a single pass).
+  template <typename Construct>
+  chain build_chain(std::size_t n, Construct& construct, std::false_type) {
+    chain c{ nullptr, nullptr, 0 };
+    try {
+      while (c.n != n) {
+        append_node(c, construct);
+      }
+    } catch (...) {
+      destroy_chain(c);
+      throw;
+    }
+    return c;
+  }
+
+  template <typename FwdIter>
+  chain build_chain(FwdIter first, FwdIter const& last, std::forward_iterator_tag) {
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    return build_chain(n, [&](node_type* p) {
+      node_alloc_traits::construct(node_alloc(), p, *first);
+      ++first;
+    });
+  }
+
+  // Single-pass input cannot be counted up front...
+  template <typename InIter>
+  chain build_chain(InIter first, InIter const& last, std::input_iterator_tag) {
+    chain c{ nullptr, nullptr, 0 };
+    auto construct = [&](node_type* p) {
+      node_alloc_traits::construct(node_alloc(), p, *first);
+    };
+    try {
+      for (; first != last; ++first) {
+        append_node(c, construct);
+      }
+    } catch (...) {
+      destroy_chain(c);
+      throw;
+    }
+    return c;
+  }
+
+  template <typename InIter>
+  chain build_chain(InIter const& first, InIter const& last) {
+    return build_chain(first, last, typename std::iterator_traits<InIter>::iterator_category{});
+  }
+
+  // Link c in between the adjacent nodes p and q: two updates at each
+  // seam regardless of the chain's length.
+  void link_chain(link_type* p, link_type* q, chain const& c) {
+    if (c.n == 0) {
+      return;
+    }
+    c.head->updateptr(nullptr, p);
+    c.tail->updateptr(nullptr, q);
+    p->updateptr(q, c.head);
+    q->updateptr(p, c.tail);
+    size_ += c.n;
+    Stats::on_insert(c.n);
+  }
+
+  // Link c in front of pos and return an iterator to its first element...
+  dllist_iter<T, Stats> insert_chain(dllist_citer<T, Stats> pos, chain const& c) {
+    link_type* p = mutable_ptr(pos.prevptr_);
+    link_type* q = mutable_ptr(pos.nodeptr_);
+    link_chain(p, q, c);
+    return dllist_iter<T, Stats>(p, c.n != 0 ? c.head : q, this->make_cursor());
+  }
+
+  // Replace the contents of the list with c. Unlike clear(), the nodes are
+  // given back one at a time since c came from the same allocator.
+  void replace_with(chain const& c) {
+    link_type* prev = &front_;
+    link_type* cur = front_.nextptr(&back_);
+    while (cur != &back_) {
+      auto next = cur->nextptr(prev);
+      destroy_node(cur);
+      prev = cur;
+      cur = next;
+    }
+    Stats::on_erase(size_);
+    front_.setptr(&back_, &back_);
+    back_.setptr(&front_, &front_);
+    size_ = 0;
+    link_chain(&front_, &back_, c);
+  }
+
+  // merge_runs() merges the sorted runs [c1, c2) and [c2, end()), where p1
+  // precedes c1 and p2 precedes c2, by relinking nodes of the second run
+  // in front of the first nodes of the first run that compare greater.
+  template <typename Compare>
+  void merge_runs(link_type* p1, link_type* c1, link_type* p2, link_type* c2, Compare& comp) {
+    while (c1 != c2 && c2 != &back_) {
+      auto after = c2->nextptr(p2);
+      if (comp(c2->to_node().datum(), c1->to_node().datum())) {
+        relink(p1, c1, p2, c2, c2, after);
+        p1 = c2;
+        c2 = after;
+      } else {
+        auto next = c1->nextptr(p1);
+        p1 = c1;
+        c1 = next;
+      }
+    }
+  }
+
 public:
   using value_type = T;
+  using allocator_type = Alloc;
+  using stats_type = Stats;
 
   using reference = value_type&;
   using const_reference = value_type const&;
@@ -314,8 +831,8 @@ public:
   using pointer = value_type*;
   using const_pointer = value_type const*;
 
-  using iterator = dllist_iter<T>;
-  using const_iterator = dllist_citer<T>;
+  using iterator = dllist_iter<T, Stats>;
+  using const_iterator = dllist_citer<T, Stats>;
 
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
@@ -325,33 +842,49 @@ public:
 
   // Default constructor...
   dllist() :
-    size_(0), front_(&back_, &back_), back_(&front_, &front_) {}
+    alloc_base(), size_(0), front_(&back_, &back_), back_(&front_, &front_) {}
+
+  // constructor dllist(alloc)
+  explicit dllist(allocator_type const& a) :
+    alloc_base(node_allocator_type(a)), size_(0), front_(&back_, &back_), back_(&front_, &front_) {}
 
   // constructor dllist(n, value)
   // This constructor will create a list of n nodes containing value as
   // their datum.
-  dllist(size_type n, T const& value = T{}) : dllist<T>{} {
-    std::fill_n(std::back_inserter(*this), n, value);
+  dllist(size_type n, T const& value = T{}) : dllist{} {
+    link_chain(&front_, &back_, build_chain(n, [&](node_type* p) {
+      node_alloc_traits::construct(node_alloc(), p, value);
+    }));
   }
 
   // constructor dllist(}{ ... })
   dllist(std::initializer_list<T> il) : dllist{} {
-    std::copy(il.begin(), il.end(), std::back_inserter(*this));
+    link_chain(&front_, &back_, build_chain(il.begin(), il.end()));
   }
+
   // constructor dllist(first, last)
-  template <typename InIter>
+  // Pass std::move_iterator values to move the elements in.
+  template <typename InIter, typename = enable_if_iterator<InIter>>
   dllist(InIter const& first, InIter const& last) : dllist{} {
-    std::copy(first, last, std::back_inserter(*this));
+    link_chain(&front_, &back_, build_chain(first, last));
   }
 
   // copy constructor
-  dllist(dllist const& l) : dllist{} {
-    std::copy(l.begin(), l.end(), std::back_inserter(*this));
+  dllist(dllist const& l) :
+    dllist{allocator_type(node_alloc_traits::select_on_container_copy_construction(l.node_alloc()))}
+  {
+    auto i = uncounted(l.begin());
+    link_chain(&front_, &back_, build_chain(l.size_, [&](node_type* p) {
+      node_alloc_traits::construct(node_alloc(), p, *i);
+      ++i;
+    }));
   }
 
   // move constructor
+  // The allocator is copied from l rather than default constructed, so a
+  // move never allocates (e.g., a new pool for dllist_pool_allocator).
   dllist(dllist&& l) :
-    dllist{}
+    alloc_base(l.node_alloc()), size_(0), front_(&back_, &back_), back_(&front_, &front_)
   {
     swap(l);
   }
@@ -368,46 +901,47 @@ public:
 
   // dllist's copy assignment operator
   dllist& operator =(dllist const& l) {
-    dllist<T> tmp(l);
+    dllist tmp(l);
     this->swap(tmp);
     return *this;
   }
 
   // move assignment operator
   dllist& operator =(dllist&& l) {
-    dllist<T> tmp(std::move(l));
+    dllist tmp(std::move(l));
     this->swap(tmp);
     return *this;
   }
 
-  // the next function implements the l.assign() call. 
-  //   1) Create a local variable called tmp of type dllist<T> and pass
-  //      in il to its constructor. 
-  //   2) swap *this and tmp.
+  // assign() builds the new nodes as a detached chain first and only then
+  // releases the old ones, so the list is unchanged if an element's
+  // constructor throws (strong guarantee). The allocator is kept.
   void assign(std::initializer_list<T> il) {
-    dllist<T> tmp(il);
-    this->swap(tmp);
+    replace_with(build_chain(il.begin(), il.end()));
   }
 
-  //   1) Create a local variable called tmp of type dllist<T> and invoke
-  //      the dllist<T> constructor appropriate for the arguments n and
-  //      value.
-  //   2) Call this->swap() to swap *this and tmp.
-  //
   void assign(size_type n, value_type const& value) {
-    dllist<T> tmp(n, value);
-    this->swap(tmp);
+    replace_with(build_chain(n, [&](node_type* p) {
+      node_alloc_traits::construct(node_alloc(), p, value);
+    }));
   }
 
-  //   1) Create a local variable called tmp of type dllist<T> and invoke
-  //      the dllist<T> constructor appropriate for the arguments first and
-  //      last.
-  //   2) Call this->swap() to swap *this and tmp.
-  //
-  template <typename InIter>
+  template <typename InIter, typename = enable_if_iterator<InIter>>
   void assign(InIter const& first, InIter const& last) {
-    dllist<T> tmp(first, last);
-    this->swap(tmp);
+    replace_with(build_chain(first, last));
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(node_alloc());
+  }
+
+  // stats() is this list's Stats policy object, e.g., its counters...
+  stats_type& stats() {
+    return *this;
+  }
+
+  stats_type const& stats() const {
+    return *this;
   }
 
   bool empty() const {
@@ -443,7 +977,7 @@ public:
   //   2) front_.nextptr(&back_) (i.e., this is the "current node")
   //
   iterator begin() {
-    return dllist_iter<T>(&front_, front_.nextptr(&back_));
+    return iterator(&front_, front_.nextptr(&back_), this->make_cursor());
   }
 
   // The constructor values to pass to iterator:
@@ -451,15 +985,15 @@ public:
   //   2) &back_ (i.e., this is the "one-past-the-end" sentinel node)
   //
   iterator end() {
-    return dllist_iter<T>(back_.nextptr(&front_), &back_);
+    return iterator(back_.nextptr(&front_), &back_, this->make_cursor());
   }
 
   const_iterator begin() const{ 
-    return dllist_citer<T>(&front_, front_.nextptr(&back_));
+    return const_iterator(&front_, front_.nextptr(&back_), this->make_cursor());
   }
 
   const_iterator end() const {
-    return dllist_citer<T>(back_.nextptr(&front_), &back_);
+    return const_iterator(back_.nextptr(&front_), &back_, this->make_cursor());
   }
 
   const_iterator cbegin() const
@@ -502,9 +1036,7 @@ public:
 
   // clear() destroys all elements in the container
   void clear() {
-    while (!this->empty()) {
-      this->pop_back();
-    }
+    clear_nodes(dllist_alloc_has_release<node_allocator_type>{});
   }
 
   void swap(dllist& l)
@@ -581,47 +1113,56 @@ public:
     front_.swap(l.front_);
     back_.swap(l.back_);
 
+    // each list's nodes now count towards the other list...
+    count_transfer(l, size_);
+    l.count_transfer(*this, l.size_);
+
     // swap sizes...
     std::swap(size_, l.size_);
+
+    // the nodes now belong to the other list, so must their allocator...
+    swap_allocators(l, typename node_alloc_traits::propagate_on_container_swap{});
   }
 
   void push_front(value_type const& v) {
-    dllist_node<T>::insert(&back_, &front_, new dllist_node<value_type>(v));
+    dllist_node<T>::insert(&back_, &front_, create_node(v));
     ++size_;
+    Stats::on_insert(1);
   }
 
   void push_front(value_type&& v) {
-    dllist_node<T>::insert(&back_, &front_, new dllist_node<value_type>(std::move(v)));
+    dllist_node<T>::insert(&back_, &front_, create_node(std::move(v)));
     ++size_;
+    Stats::on_insert(1);
   }
 
   void pop_front() {
     auto old = dllist_node<T>::remove(&back_, &front_);
-    delete old;
+    destroy_node(old);
     --size_;
+    Stats::on_erase(1);
   }
 
   void push_back(value_type const& v) {
-    dllist_node<T>::insert(&front_, &back_, new dllist_node<value_type>(v));
+    dllist_node<T>::insert(&front_, &back_, create_node(v));
     ++size_;
+    Stats::on_insert(1);
   }
   void push_back(value_type&& v) {
-    dllist_node<T>::insert(&front_, &back_, new dllist_node<value_type>(std::move(v)));
+    dllist_node<T>::insert(&front_, &back_, create_node(std::move(v)));
     ++size_;
+    Stats::on_insert(1);
   }
   void pop_back() {
     auto old = dllist_node<T>::remove(&front_, &back_);
-    delete old;
+    destroy_node(old);
     --size_;
+    Stats::on_erase(1);
   }
 
   template <typename... Args>
   iterator emplace(iterator pos, Args&&... args) {
-    --pos;
-    auto newnode = new dllist_node<T>{T(std::forward<Args>(args)...)};
-    auto nextnode = dllist_node<T>::insert(pos.prevptr_, pos.nodeptr_, newnode);
-    ++size_;
-    return iterator(newnode, nextnode);
+    return link_node(pos, create_node(T(std::forward<Args>(args)...)));
   }
 
   template <typename... Args>
@@ -634,28 +1175,42 @@ public:
     this->emplace(end(), std::forward<Args>(args)...);
   }
 
+  // insert(pos, value) returns an iterator to the inserted element...
   iterator insert(iterator pos, value_type const& value) {
-    --pos;
-    auto newnode = new dllist_node<T>(value);
-    auto nextnode = dllist_node<T>::insert(pos.prevptr_, pos.nodeptr_, newnode);
-    ++size_;
-    return pos;
+    return link_node(pos, create_node(value));
   }
 
-  template <typename InIter>
-  void insert(iterator pos, InIter first, InIter const& last) {
-    for (; first != last; ++first) {
-      pos = insert(pos, *first);
-    }
+  iterator insert(iterator pos, value_type&& value) {
+    return link_node(pos, create_node(std::move(value)));
+  }
+
+  // The multi-element inserts build a detached chain and link it in front
+  // of pos with one patch per seam. They return an iterator to the first
+  // inserted element (or pos if nothing was inserted) and leave the list
+  // unchanged if an element's constructor throws.
+  iterator insert(const_iterator pos, size_type n, value_type const& value) {
+    return insert_chain(pos, build_chain(n, [&](node_type* p) {
+      node_alloc_traits::construct(node_alloc(), p, value);
+    }));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> il) {
+    return insert_chain(pos, build_chain(il.begin(), il.end()));
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  iterator insert(const_iterator pos, InIter const& first, InIter const& last) {
+    return insert_chain(pos, build_chain(first, last));
   }
 
   iterator erase(iterator pos) {
-    --pos;
-    auto oldnode = dllist_node<T>::remove(pos.prevptr_, pos.nodeptr_);
-    delete oldnode;
-    ++pos;
+    link_type* p = pos.prevptr_;
+    link_type* q = pos.nodeptr_;
+    link_type* next = q->nextptr(p);
+    destroy_node(link_type::remove(p->nextptr(q), p));
     --size_;
-    return pos;
+    Stats::on_erase(1);
+    return iterator(p, next, this->make_cursor());
   }
 
   iterator erase(iterator first, iterator const& last) {
@@ -664,118 +1219,367 @@ public:
     }
     return first;
   }
+
+  // The operations below relink nodes instead of copying elements. As with
+  // every XOR-encoded list, an iterator also remembers its neighbour, so
+  // iterators next to a relinked seam are invalidated.
+
+  // splice(pos, l) moves all elements of l in front of pos. O(1).
+  void splice(const_iterator pos, dllist& l) {
+    if (this != &l && !l.empty()) {
+      splice_nodes(pos, l, l.begin(), l.end(), l.size_);
+    }
+  }
+
+  void splice(const_iterator pos, dllist&& l) {
+    splice(pos, l);
+  }
+
+  // splice(pos, l, i) moves the element at i in front of pos. O(1).
+  void splice(const_iterator pos, dllist& l, const_iterator i) {
+    auto last = uncounted(i);
+    splice_nodes(pos, l, i, ++last, 1);
+  }
+
+  void splice(const_iterator pos, dllist&& l, const_iterator i) {
+    splice(pos, l, i);
+  }
+
+  // splice(pos, l, first, last) moves [first, last) in front of pos. The
+  // relinking is O(1); counting the moved elements to keep size() exact is
+  // only needed (and is linear) when l is a different list.
+  void splice(const_iterator pos, dllist& l, const_iterator first, const_iterator last) {
+    if (first != last) {
+      size_type n = this != &l ? static_cast<size_type>(std::distance(uncounted(first), last)) : 0;
+      splice_nodes(pos, l, first, last, n);
+    }
+  }
+
+  void splice(const_iterator pos, dllist&& l, const_iterator first, const_iterator last) {
+    splice(pos, l, first, last);
+  }
+
+  // merge(l, comp) merges the sorted list l into this sorted list. The
+  // merge is stable and allocation-free; l is left empty.
+  template <typename Compare>
+  void merge(dllist& l, Compare comp) {
+    if (this == &l || l.empty()) {
+      return;
+    }
+    size_type n = size_;
+    splice(end(), l);
+
+    link_type* p = &front_;
+    link_type* c = front_.nextptr(&back_);
+    for (size_type i = 0; i != n; ++i) {
+      auto next = c->nextptr(p);
+      p = c;
+      c = next;
+    }
+    merge_runs(&front_, front_.nextptr(&back_), p, c, comp);
+  }
+
+  template <typename Compare>
+  void merge(dllist&& l, Compare comp) {
+    merge(l, comp);
+  }
+
+  void merge(dllist& l) {
+    merge(l, std::less<T>());
+  }
+
+  void merge(dllist&& l) {
+    merge(l, std::less<T>());
+  }
+
+  // sort(comp) is a stable, in-place, allocation-free merge sort.
+  //
+  // While sorting, each node's xorptr_ holds next ^ nullptr (i.e., a plain
+  // "next" pointer) so the bottom-up merge passes can walk a singly-linked
+  // chain. The XOR links are rebuilt in a single pass at the end, or before
+  // rethrowing if comp throws (the list then holds the same elements in an
+  // unspecified order).
+  template <typename Compare>
+  void sort(Compare comp) {
+    if (size_ < 2) {
+      return;
+    }
+
+    auto next_of = [](link_type* n) {
+      return n->nextptr(static_cast<link_type*>(nullptr));
+    };
+    auto set_next = [](link_type* n, link_type* next) {
+      n->setptr(next, nullptr);
+    };
+
+    // Convert the XOR links into "next" links...
+    link_type* head = front_.nextptr(&back_);
+    {
+      link_type* prev = &front_;
+      link_type* cur = head;
+      while (cur != &back_) {
+        auto next = cur->nextptr(prev);
+        set_next(cur, next != &back_ ? next : nullptr);
+        prev = cur;
+        cur = next;
+      }
+    }
+
+    // Rebuild the XOR links from the "next" links starting at head...
+    auto rebuild = [&](link_type* head) {
+      link_type* prev = &front_;
+      link_type* cur = head;
+      while (cur != nullptr) {
+        auto next = next_of(cur);
+        cur->setptr(prev, next != nullptr ? next : &back_);
+        prev = cur;
+        cur = next;
+      }
+      front_.setptr(&back_, head);
+      back_.setptr(prev, &front_);
+    };
+
+    link_type* p = nullptr;
+    link_type* q = nullptr;
+    link_type* tail = nullptr;
+    size_type psize = 0;
+    size_type qsize = 0;
+
+    auto append = [&](link_type* e) {
+      if (tail != nullptr) {
+        set_next(tail, e);
+      } else {
+        head = e;
+      }
+      tail = e;
+    };
+
+    try {
+      // Merge runs of width 1, 2, 4, ... until a pass does only one merge...
+      for (size_type width = 1; ; width *= 2) {
+        p = head;
+        tail = nullptr;
+        size_type merges = 0;
+        head = nullptr;
+
+        while (p != nullptr) {
+          ++merges;
+          q = p;
+          psize = 0;
+          while (psize != width && q != nullptr) {
+            ++psize;
+            q = next_of(q);
+          }
+          qsize = width;
+
+          while (psize != 0 || (qsize != 0 && q != nullptr)) {
+            link_type* e;
+            if (psize == 0) {
+              e = q; q = next_of(q); --qsize;
+            } else if (qsize == 0 || q == nullptr) {
+              e = p; p = next_of(p); --psize;
+            } else if (comp(q->to_node().datum(), p->to_node().datum())) {
+              e = q; q = next_of(q); --qsize;
+            } else {
+              e = p; p = next_of(p); --psize;
+            }
+            append(e);
+          }
+          p = q;
+        }
+        set_next(tail, nullptr);
+
+        if (merges <= 1) {
+          break;
+        }
+      }
+    } catch (...) {
+      // comp threw in the middle of a merge. The unmerged nodes of the p
+      // and q runs still have their old "next" links, so join the merged
+      // prefix, the rest of both runs and the rest of the chain, and
+      // restore the XOR links. Every element is kept, in some order.
+      link_type* rest = q;
+      for (size_type k = qsize; k != 0 && rest != nullptr; --k) {
+        rest = next_of(rest);
+      }
+      for (; psize != 0; --psize) {
+        auto e = p;
+        p = next_of(p);
+        append(e);
+      }
+      while (q != rest) {
+        auto e = q;
+        q = next_of(q);
+        append(e);
+      }
+      if (tail != nullptr) {
+        set_next(tail, rest);
+      } else {
+        head = rest;
+      }
+      rebuild(head);
+      throw;
+    }
+
+    rebuild(head);
+  }
+
+  void sort() {
+    sort(std::less<T>());
+  }
+
+  // reverse() is O(1): the first and last nodes trade sentinels, i.e.,
+  // front_ and back_ swap roles.
+  void reverse() {
+    if (size_ < 2) {
+      return;
+    }
+    auto first = front_.nextptr(&back_);
+    auto last = back_.nextptr(&front_);
+    first->updateptr(&front_, &back_);
+    last->updateptr(&back_, &front_);
+    front_.setptr(&back_, last);
+    back_.setptr(first, &front_);
+  }
+
+  // unique(pred) erases all but the first of each run of consecutive
+  // elements for which pred holds.
+  template <typename BinaryPredicate>
+  void unique(BinaryPredicate pred) {
+    link_type* p = &front_;
+    link_type* c = front_.nextptr(&back_);
+    if (c == &back_) {
+      return;
+    }
+    link_type* n = c->nextptr(p);
+    while (n != &back_) {
+      if (pred(c->to_node().datum(), n->to_node().datum())) {
+        destroy_node(link_type::remove(p, c));
+        --size_;
+        Stats::on_erase(1);
+      } else {
+        p = c;
+        c = n;
+      }
+      n = c->nextptr(p);
+    }
+  }
+
+  void unique() {
+    unique(std::equal_to<T>());
+  }
 };
 
 //===========================================================================
 
-template <typename T>
-inline void swap(dllist<T>& a, dllist<T>& b)
+template <typename T, typename Alloc, typename Stats>
+inline void swap(dllist<T, Alloc, Stats>& a, dllist<T, Alloc, Stats>& b)
 {
   a.swap(b);
 }
 
-template <typename T>
-inline bool operator ==(dllist<T> const& a, dllist<T> const& b) {
+template <typename T, typename Alloc, typename Stats>
+inline bool operator ==(dllist<T, Alloc, Stats> const& a, dllist<T, Alloc, Stats> const& b) {
   return std::equal(a, b);
 }
 
-template <typename T>
-inline bool operator !=(dllist<T> const& a, dllist<T> const& b)
+template <typename T, typename Alloc, typename Stats>
+inline bool operator !=(dllist<T, Alloc, Stats> const& a, dllist<T, Alloc, Stats> const& b)
 {
   return !(operator ==(a,b));
 }
 
-template <typename T>
-inline bool operator <(dllist<T> const& a, dllist<T> const& b) {
+template <typename T, typename Alloc, typename Stats>
+inline bool operator <(dllist<T, Alloc, Stats> const& a, dllist<T, Alloc, Stats> const& b) {
   return std::lexicographical_compare(a, b);
 }
 
-template <typename T>
-inline bool operator <=(dllist<T> const& a, dllist<T> const& b)
+template <typename T, typename Alloc, typename Stats>
+inline bool operator <=(dllist<T, Alloc, Stats> const& a, dllist<T, Alloc, Stats> const& b)
 {
   return !(a > b);
 }
 
-template <typename T>
-inline bool operator >=(dllist<T> const& a, dllist<T> const& b)
+template <typename T, typename Alloc, typename Stats>
+inline bool operator >=(dllist<T, Alloc, Stats> const& a, dllist<T, Alloc, Stats> const& b)
 {
   return !(a < b);
 }
 
-template <typename T>
-inline bool operator >(dllist<T> const& a, dllist<T> const& b)
+template <typename T, typename Alloc, typename Stats>
+inline bool operator >(dllist<T, Alloc, Stats> const& a, dllist<T, Alloc, Stats> const& b)
 {
   return b < a;
 }
 
-template <typename T>
-inline auto begin(dllist<T>& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto begin(dllist<T, Alloc, Stats>& a)
 {
   return a.begin();
 }
 
-template <typename T>
-inline auto begin(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto begin(dllist<T, Alloc, Stats> const& a)
 {
   return a.begin();
 }
 
-template <typename T>
-inline auto cbegin(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto cbegin(dllist<T, Alloc, Stats> const& a)
 {
   return a.begin();
 }
 
-template <typename T>
-inline auto rbegin(dllist<T>& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto rbegin(dllist<T, Alloc, Stats>& a)
 {
   return a.rbegin();
 }
 
-template <typename T>
-inline auto rbegin(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto rbegin(dllist<T, Alloc, Stats> const& a)
 {
   return a.rbegin();
 }
 
-template <typename T>
-inline auto crbegin(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto crbegin(dllist<T, Alloc, Stats> const& a)
 {
   return a.crbegin();
 }
 
-template <typename T>
-inline auto end(dllist<T>& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto end(dllist<T, Alloc, Stats>& a)
 {
   return a.end();
 }
 
-template <typename T>
-inline auto end(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto end(dllist<T, Alloc, Stats> const& a)
 {
   return a.end();
 }
 
-template <typename T>
-inline auto cend(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto cend(dllist<T, Alloc, Stats> const& a)
 {
   return a.end();
 }
 
-template <typename T>
-inline auto rend(dllist<T>& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto rend(dllist<T, Alloc, Stats>& a)
 {
   return a.rend();
 }
 
-template <typename T>
-inline auto rend(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto rend(dllist<T, Alloc, Stats> const& a)
 {
   return a.rend();
 }
 
-template <typename T>
-inline auto crend(dllist<T> const& a)
+template <typename T, typename Alloc, typename Stats>
+inline auto crend(dllist<T, Alloc, Stats> const& a)
 {
   return a.crend();
 }
@@ -783,23 +1587,34 @@ inline auto crend(dllist<T> const& a)
 //===========================================================================
 
 //
-// dllist_iter<T>
+// dllist_iter<T, Stats>
 //
-// The dllist_iter<T> defines the non-const T iterator type 
-template <typename T>
-class dllist_iter : public std::iterator<std::bidirectional_iterator_tag, T, std::ptrdiff_t, T*, T&> {
+// The dllist_iter<T> defines the non-const T iterator type. Its private
+// Stats::cursor base counts node visits; it is empty unless statistics
+// are enabled.
+template <typename T, typename Stats>
+class dllist_iter :
+  public std::iterator<std::bidirectional_iterator_tag, T, std::ptrdiff_t, T*, T&>,
+  private Stats::cursor
+{
 private:
-  friend class dllist<T>;
-  friend class dllist_citer<T>;
+  template <typename, typename, typename> friend class dllist;
+  friend class dllist_citer<T, Stats>;
+
+  using cursor_type = typename Stats::cursor;
 
   dllist_node_ptr_only<T>* prevptr_; // Used to compute next node address
   dllist_node_ptr_only<T>* nodeptr_; // Cur node; for xorptr_ value
 
+  cursor_type const& cursor() const {
+    return *this;
+  }
+
 public:
   // The default constructor simply initializes prevptr_ and nodeptr_
   // to nullptr. 
   dllist_iter() :
-    prevptr_{nullptr}, nodeptr_{nullptr} {}
+    cursor_type{}, prevptr_{nullptr}, nodeptr_{nullptr} {}
 
   dllist_iter(dllist_iter const&) = default;
   dllist_iter& operator =(dllist_iter const&) = default;
@@ -809,8 +1624,11 @@ public:
 
   ~dllist_iter() = default;
 
-  dllist_iter(dllist_node_ptr_only<T>* prev, dllist_node_ptr_only<T>* xornode) :
-    prevptr_{prev}, nodeptr_{xornode} {}
+  dllist_iter(
+    dllist_node_ptr_only<T>* prev, dllist_node_ptr_only<T>* xornode,
+    cursor_type const& c = cursor_type{}
+  ) :
+    cursor_type(c), prevptr_{prev}, nodeptr_{xornode} {}
 
   bool operator ==(dllist_iter const& i) const {
     return nodeptr_ == i.nodeptr_;
@@ -831,6 +1649,7 @@ public:
   }
 
   dllist_iter& operator ++() {
+    cursor_type::visit();
     auto next_nodeptr_ = nodeptr_->nextptr(prevptr_);
     prevptr_ = nodeptr_;
     nodeptr_ = next_nodeptr_;
@@ -838,12 +1657,13 @@ public:
   }
 
   dllist_iter operator ++(int) {
-    dllist_iter<T> tmp(*this);
+    dllist_iter tmp(*this);
     operator++();
     return tmp;
   }
 
   dllist_iter& operator --() {
+    cursor_type::visit();
     auto prev_prevptr_ = prevptr_->nextptr(nodeptr_);
     nodeptr_ = prevptr_;
     prevptr_ = prev_prevptr_;
@@ -851,7 +1671,7 @@ public:
   }
 
   dllist_iter operator --(int) {
-    dllist_iter<T> tmp(*this);
+    dllist_iter tmp(*this);
     operator--();
     return tmp;
   }
@@ -859,20 +1679,25 @@ public:
 
 //===========================================================================
 //
-// dllist_citer
+// dllist_citer<T, Stats>
 //
 // T is const and therefore return values, etc. are const.
-template <typename T>
-class dllist_citer : public std::iterator<std::bidirectional_iterator_tag, T const, std::ptrdiff_t, T const*, T const&> {
+template <typename T, typename Stats>
+class dllist_citer :
+  public std::iterator<std::bidirectional_iterator_tag, T const, std::ptrdiff_t, T const*, T const&>,
+  private Stats::cursor
+{
 private:
-  friend class dllist<T>;
+  template <typename, typename, typename> friend class dllist;
+
+  using cursor_type = typename Stats::cursor;
 
   dllist_node_ptr_only<T> const* prevptr_; // Used to compute next node address
   dllist_node_ptr_only<T> const* nodeptr_; // Cur node; for xorptr_ value
 
 public:
   dllist_citer() :
-    prevptr_{nullptr}, nodeptr_{nullptr} {}
+    cursor_type{}, prevptr_{nullptr}, nodeptr_{nullptr} {}
 
   dllist_citer(dllist_citer const&) = default;
   dllist_citer& operator =(dllist_citer const&) = default;
@@ -882,23 +1707,27 @@ public:
 
   ~dllist_citer() = default;
 
-  dllist_citer(dllist_node_ptr_only<T> const* prev, dllist_node_ptr_only<T> const* xornode) :
-    prevptr_{prev}, nodeptr_{xornode} {}
+  dllist_citer(
+    dllist_node_ptr_only<T> const* prev, dllist_node_ptr_only<T> const* xornode,
+    cursor_type const& c = cursor_type{}
+  ) :
+    cursor_type(c), prevptr_{prev}, nodeptr_{xornode} {}
 
-  dllist_citer(dllist_iter<T> const& i) :
-    nodeptr_{i.nodeptr_}, prevptr_{i.prevptr_} {}
+  dllist_citer(dllist_iter<T, Stats> const& i) :
+    cursor_type(i.cursor()), prevptr_{i.prevptr_}, nodeptr_{i.nodeptr_} {}
 
-  dllist_citer& operator =(dllist_iter<T> const& i) {
+  dllist_citer& operator =(dllist_iter<T, Stats> const& i) {
+    cursor_type::operator =(i.cursor());
     nodeptr_ = i.nodeptr_;
     prevptr_ = i.prevptr_;
     return *this;
   }
 
-  bool operator ==(dllist_iter<T> const& i) const {
+  bool operator ==(dllist_iter<T, Stats> const& i) const {
     return nodeptr_ == i.nodeptr_;
   }
 
-  bool operator !=(dllist_iter<T> const& i) const {
+  bool operator !=(dllist_iter<T, Stats> const& i) const {
     return !operator ==(i);
   }
 
@@ -919,6 +1748,7 @@ public:
   }
 
   dllist_citer& operator ++() {
+    cursor_type::visit();
     auto next_nodeptr_ = nodeptr_->nextptr(prevptr_);
     prevptr_ = nodeptr_;
     nodeptr_ = next_nodeptr_;
@@ -926,12 +1756,13 @@ public:
   }
 
   dllist_citer operator ++(int) {
-    dllist_citer<T> tmp(*this);
+    dllist_citer tmp(*this);
     operator++();
     return tmp;
   }
 
   dllist_citer& operator --() {
+    cursor_type::visit();
     auto prev_prevptr_ = prevptr_->nextptr(nodeptr_);
     nodeptr_ = prevptr_;
     prevptr_ = prev_prevptr_;
@@ -939,7 +1770,7 @@ public:
   }
 
   dllist_citer operator --(int) {
-    dllist_citer<T> tmp(*this);
+    dllist_citer tmp(*this);
     operator--();
     return tmp;
   }
@@ -947,14 +1778,14 @@ public:
 
 //===========================================================================
 
-template <typename T>
-inline bool operator ==(dllist_iter<T> const& i, dllist_citer<T> const& j)
+template <typename T, typename Stats>
+inline bool operator ==(dllist_iter<T, Stats> const& i, dllist_citer<T, Stats> const& j)
 {
   return j == i;
 }
 
-template <typename T>
-inline bool operator !=(dllist_iter<T> const& i, dllist_citer<T> const& j)
+template <typename T, typename Stats>
+inline bool operator !=(dllist_iter<T, Stats> const& i, dllist_citer<T, Stats> const& j)
 {
   return j != i;
 }
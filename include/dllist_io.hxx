@@ -0,0 +1,241 @@
+// The code here is to implement a flat binary image of a dllist<T> of
+// trivially copyable elements, written and read through streams or loaded
+// straight from a memory-mapped file.
+
+#ifndef DLLIST_IO_HXX
+#define DLLIST_IO_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "dllist.hxx"
+
+#if defined __unix__ || defined __APPLE__
+#define DLLIST_IO_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//===========================================================================
+//
+// The image is a fixed 32-byte header followed by the elements' bytes in
+// list order. The XOR links are not stored: they are absolute addresses
+// and are recomputed when the list is rebuilt.
+//
+//   offset  size  field
+//        0     8  magic       "DLLIST\0\0"
+//        8     4  version     dllist_image_version
+//       12     4  byte_order  0x01020304 as written by the producer
+//       16     8  elem_size   sizeof(T)
+//       24     8  count       number of elements
+//       32        count * elem_size bytes of element data
+//
+// Integers and elements are stored in the producer's native
+// representation. An image can only be read back on a platform with the
+// same byte order and layout of T; byte_order and elem_size catch the
+// obvious mismatches.
+//
+struct dllist_image_header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t elem_size;
+  std::uint64_t count;
+};
+
+static_assert(sizeof(dllist_image_header) == 32, "unexpected dllist_image_header padding");
+
+constexpr std::uint32_t dllist_image_version = 1;
+
+// Every malformed image or failed stream operation throws dllist_io_error...
+class dllist_io_error : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+namespace dllist_io_detail {
+
+// Elements are copied through a buffer of about this many bytes...
+constexpr std::size_t chunk_bytes = std::size_t{1} << 16;
+
+template <typename T>
+constexpr std::size_t chunk_elems() {
+  return sizeof(T) < chunk_bytes ? chunk_bytes / sizeof(T) : 1;
+}
+
+template <typename T>
+void check_element_type() {
+  static_assert(std::is_trivially_copyable<T>::value,
+    "dllist images require a trivially copyable T");
+  static_assert(alignof(T) <= sizeof(dllist_image_header),
+    "dllist images require alignof(T) <= 32");
+}
+
+inline dllist_image_header make_header(std::size_t elem_size, std::size_t count) {
+  dllist_image_header h;
+  std::memcpy(h.magic, "DLLIST\0\0", sizeof h.magic);
+  h.version = dllist_image_version;
+  h.byte_order = 0x01020304;
+  h.elem_size = elem_size;
+  h.count = count;
+  return h;
+}
+
+inline void check_header(dllist_image_header const& h, std::size_t elem_size) {
+  if (std::memcmp(h.magic, "DLLIST\0\0", sizeof h.magic) != 0) {
+    throw dllist_io_error("dllist image: bad magic");
+  }
+  if (h.version != dllist_image_version) {
+    throw dllist_io_error("dllist image: unsupported version " + std::to_string(h.version));
+  }
+  if (h.byte_order != 0x01020304) {
+    throw dllist_io_error("dllist image: byte order mismatch");
+  }
+  if (h.elem_size != elem_size) {
+    throw dllist_io_error(
+      "dllist image: element size " + std::to_string(h.elem_size) +
+      ", expected " + std::to_string(elem_size)
+    );
+  }
+}
+
+} // namespace dllist_io_detail
+
+//===========================================================================
+
+// dllist_serialize(os, l) writes the image of l to os, which should be
+// opened in binary mode. The elements are gathered into 64 KiB chunks so
+// that each write() hands the stream a large block. The list is walked
+// without its Stats cursor, so serializing does not count as visits.
+template <typename T, typename Alloc, typename Stats>
+void dllist_serialize(std::ostream& os, dllist<T, Alloc, Stats> const& l) {
+  dllist_io_detail::check_element_type<T>();
+
+  auto header = dllist_io_detail::make_header(sizeof(T), l.size());
+  os.write(reinterpret_cast<char const*>(&header), sizeof header);
+
+  std::vector<char> buffer(dllist_io_detail::chunk_elems<T>() * sizeof(T));
+  std::size_t used = 0;
+  for (auto i = l.uncounted(l.begin()); i != l.end(); ++i) {
+    std::memcpy(buffer.data() + used, &*i, sizeof(T));
+    used += sizeof(T);
+    if (used == buffer.size()) {
+      os.write(buffer.data(), static_cast<std::streamsize>(used));
+      used = 0;
+    }
+  }
+  os.write(buffer.data(), static_cast<std::streamsize>(used));
+
+  if (!os) {
+    throw dllist_io_error("dllist image: write failed");
+  }
+}
+
+// dllist_deserialize(is, l) replaces the contents of l with the image read
+// from is (opened in binary mode). Each chunk is linked in as one
+// pre-built chain. With dllist_pool_allocator a chunk first takes any nodes
+// on the pool's free list and gets the rest as one block, so only a load
+// into a fresh pool gets one block per chunk. l is unchanged if the image
+// is malformed or truncated.
+template <typename T, typename Alloc, typename Stats>
+void dllist_deserialize(std::istream& is, dllist<T, Alloc, Stats>& l) {
+  dllist_io_detail::check_element_type<T>();
+
+  dllist_image_header header;
+  if (!is.read(reinterpret_cast<char*>(&header), sizeof header)) {
+    throw dllist_io_error("dllist image: truncated header");
+  }
+  dllist_io_detail::check_header(header, sizeof(T));
+
+  using storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+  std::vector<storage> buffer(dllist_io_detail::chunk_elems<T>());
+  T const* chunk = reinterpret_cast<T const*>(buffer.data());
+
+  dllist<T, Alloc, Stats> tmp(l.get_allocator());
+  for (std::uint64_t left = header.count; left != 0; ) {
+    auto n = static_cast<std::size_t>(std::min<std::uint64_t>(left, buffer.size()));
+    if (!is.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(n * sizeof(T)))) {
+      throw dllist_io_error("dllist image: truncated data");
+    }
+    tmp.insert(tmp.cend(), chunk, chunk + n);
+    left -= n;
+  }
+  l.swap(tmp);
+}
+
+#if defined DLLIST_IO_HAVE_MMAP
+
+// dllist_load_mapped(path, l) replaces the contents of l with the image in
+// the file path. The file is memory-mapped and its element array is
+// handed to assign() as one range, so every node is constructed straight
+// from the mapping and its xorptr_ is computed in the same single pass.
+// With dllist_pool_allocator, nodes on the pool's free list are used
+// first and the rest come from one contiguous block (one allocation).
+// So all n nodes form one block only if the pool has no free nodes, e.g.,
+// when l is a new list. l's old nodes are freed only after the new ones
+// are built, and a reload into a list that already has elements cannot
+// reuse them. Other allocators are called once per node. l is unchanged
+// if the file cannot be read or is malformed.
+template <typename T, typename Alloc, typename Stats>
+void dllist_load_mapped(char const* path, dllist<T, Alloc, Stats>& l) {
+  dllist_io_detail::check_element_type<T>();
+
+  struct mapping {
+    int fd = -1;
+    void* addr = MAP_FAILED;
+    std::size_t size = 0;
+
+    ~mapping() {
+      if (addr != MAP_FAILED) {
+        ::munmap(addr, size);
+      }
+      if (fd != -1) {
+        ::close(fd);
+      }
+    }
+  } m;
+
+  m.fd = ::open(path, O_RDONLY);
+  if (m.fd == -1) {
+    throw dllist_io_error(std::string("dllist image: cannot open ") + path);
+  }
+  struct stat st;
+  if (::fstat(m.fd, &st) != 0) {
+    throw dllist_io_error(std::string("dllist image: cannot stat ") + path);
+  }
+  m.size = static_cast<std::size_t>(st.st_size);
+  if (m.size < sizeof(dllist_image_header)) {
+    throw dllist_io_error("dllist image: truncated header");
+  }
+  m.addr = ::mmap(nullptr, m.size, PROT_READ, MAP_PRIVATE, m.fd, 0);
+  if (m.addr == MAP_FAILED) {
+    throw dllist_io_error(std::string("dllist image: cannot map ") + path);
+  }
+  ::madvise(m.addr, m.size, MADV_SEQUENTIAL);     // a hint; failure is harmless
+
+  auto bytes = static_cast<char const*>(m.addr);
+  dllist_image_header header;
+  std::memcpy(&header, bytes, sizeof header);
+  dllist_io_detail::check_header(header, sizeof(T));
+  if (header.count > (m.size - sizeof header) / sizeof(T)) {
+    throw dllist_io_error("dllist image: truncated data");
+  }
+
+  // The mapping is page-aligned and the header is 32 bytes, so the
+  // element array is suitably aligned for T.
+  auto first = reinterpret_cast<T const*>(bytes + sizeof header);
+  l.assign(first, first + header.count);
+}
+
+#endif // #if defined DLLIST_IO_HAVE_MMAP
+
+#endif // #ifndef DLLIST_IO_HXX
@@ -0,0 +1,349 @@
+// The code here is to implement a slab/arena node pool for dllist<T, Alloc>.
+
+#ifndef DLLIST_POOL_HXX
+#define DLLIST_POOL_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+template <typename T, std::size_t NodesPerSlab>
+class dllist_pool;              // slab pool of T-sized slots
+
+template <std::size_t NodesPerSlab>
+class dllist_pool_resource;     // dllist_pools shared by rebound allocators
+
+template <typename T, std::size_t NodesPerSlab = 64>
+class dllist_pool_allocator;    // allocator handing out dllist_pool slots
+
+//===========================================================================
+//
+// dllist_pool<T, NodesPerSlab>
+//
+// A dllist_pool hands out T-sized slots carved from contiguous slabs of
+// (at least) NodesPerSlab slots. Slots given back by deallocate() are
+// kept on a free list and reused before any new slab is requested, so a
+// list that pushes and pops at the same rate never touches ::operator new.
+// The slabs themselves are only returned by release() (or the destructor),
+// which frees every slot of the pool at once.
+//
+// A request for n > 1 slots is served from one contiguous run of a slab;
+// the slots of such a run may later be given back one at a time. Such a
+// request never takes slots from the free list, so callers that allocate
+// in bulk should check has_free() first and reuse freed slots one at a
+// time (dllist's bulk builds do).
+//
+template <typename T, std::size_t NodesPerSlab>
+class dllist_pool final {
+private:
+  static_assert(NodesPerSlab > 0, "NodesPerSlab must be positive");
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+    "over-aligned types are not supported by dllist_pool");
+
+  union slot {
+    slot* next;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  struct slab {
+    slab* next;
+  };
+
+  // The slab header is padded so that the first slot is suitably aligned...
+  static constexpr std::size_t header_size =
+    (sizeof(slab) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+
+  slab* slabs_;       // all slabs owned by this pool
+  slot* free_;        // recycled slots
+  slot* bump_;        // next never-used slot of the newest slab
+  slot* bump_end_;    // one-past-the-end of the newest slab
+  std::size_t slots_; // slots in all slabs
+  std::size_t slab_count_;
+
+  // Push the slots [first, first + n) on to the free list so that they
+  // are handed out again in ascending address order.
+  void push_free(slot* first, std::size_t n) noexcept {
+    while (n != 0) {
+      --n;
+      first[n].next = free_;
+      free_ = &first[n];
+    }
+  }
+
+  // Start a new slab big enough for n slots. The unused tail of the
+  // current slab is moved to the free list so that it is not lost.
+  void grow(std::size_t n) {
+    auto count = std::max(n, NodesPerSlab);
+    void* raw = ::operator new(header_size + count * sizeof(slot));
+    auto s = static_cast<slab*>(raw);
+    s->next = slabs_;
+    slabs_ = s;
+    slots_ += count;
+    ++slab_count_;
+
+    push_free(bump_, static_cast<std::size_t>(bump_end_ - bump_));
+    bump_ = reinterpret_cast<slot*>(static_cast<unsigned char*>(raw) + header_size);
+    bump_end_ = bump_ + count;
+  }
+
+public:
+  dllist_pool() noexcept :
+    slabs_(nullptr), free_(nullptr), bump_(nullptr), bump_end_(nullptr), slots_(0), slab_count_(0) {}
+
+  // Prohibitions...
+  dllist_pool(dllist_pool const&) = delete;
+  dllist_pool& operator =(dllist_pool const&) = delete;
+
+  ~dllist_pool() {
+    release();
+  }
+
+  T* allocate(std::size_t n) {
+    if (n == 1 && free_ != nullptr) {
+      auto s = free_;
+      free_ = s->next;
+      return reinterpret_cast<T*>(s);
+    }
+    if (static_cast<std::size_t>(bump_end_ - bump_) < n) {
+      grow(n);
+    }
+    auto s = bump_;
+    bump_ += n;
+    return reinterpret_cast<T*>(s);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    push_free(reinterpret_cast<slot*>(p), n);
+  }
+
+  // true if a slot given back by deallocate() is waiting to be reused
+  bool has_free() const noexcept {
+    return free_ != nullptr;
+  }
+
+  // Number of slots in all slabs, whether in use or not...
+  std::size_t capacity() const noexcept {
+    return slots_;
+  }
+
+  // Bytes obtained from ::operator new for all slabs: each slot is at least
+  // a pointer wide (for the free list), and each slab has a header.
+  std::size_t capacity_bytes() const noexcept {
+    return slots_ * sizeof(slot) + slab_count_ * header_size;
+  }
+
+  // Free every slab at once. Any slot still in use becomes invalid.
+  void release() noexcept {
+    while (slabs_ != nullptr) {
+      auto next = slabs_->next;
+      ::operator delete(slabs_);
+      slabs_ = next;
+    }
+    free_ = bump_ = bump_end_ = nullptr;
+    slots_ = slab_count_ = 0;
+  }
+};
+
+//===========================================================================
+//
+// dllist_pool_resource<NodesPerSlab>
+//
+// A dllist_pool_resource owns one dllist_pool per slot size and alignment.
+// Each pool is created on first use, so allocators rebound from one
+// another (e.g., a list's dllist_node<T> allocator and its
+// get_allocator()) share a resource without every value type getting
+// slabs of its own. Types of equal size and alignment share a pool.
+//
+template <std::size_t NodesPerSlab>
+class dllist_pool_resource final {
+private:
+  struct entry_base {
+    entry_base* next;
+    std::size_t size;
+    std::size_t align;
+
+    entry_base(entry_base* n, std::size_t s, std::size_t a) noexcept :
+      next(n), size(s), align(a) {}
+    virtual ~entry_base() = default;
+
+    virtual std::size_t capacity_bytes() const noexcept = 0;
+  };
+
+  template <typename Slot>
+  struct entry final : entry_base {
+    dllist_pool<Slot, NodesPerSlab> pool;
+
+    explicit entry(entry_base* n) noexcept :
+      entry_base(n, sizeof(Slot), alignof(Slot)) {}
+
+    std::size_t capacity_bytes() const noexcept override {
+      return pool.capacity_bytes();
+    }
+  };
+
+  entry_base* pools_;   // one entry per slot size and alignment
+
+public:
+  // The slot type of the pool serving T...
+  template <typename T>
+  using slot_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  template <typename T>
+  using pool_type = dllist_pool<slot_type<T>, NodesPerSlab>;
+
+  dllist_pool_resource() noexcept :
+    pools_(nullptr) {}
+
+  // Prohibitions...
+  dllist_pool_resource(dllist_pool_resource const&) = delete;
+  dllist_pool_resource& operator =(dllist_pool_resource const&) = delete;
+
+  ~dllist_pool_resource() {
+    while (pools_ != nullptr) {
+      auto next = pools_->next;
+      delete pools_;
+      pools_ = next;
+    }
+  }
+
+  // pool<T>() returns the pool serving T, creating it if needed.
+  template <typename T>
+  pool_type<T>& pool() {
+    using slot = slot_type<T>;
+    for (auto e = pools_; e != nullptr; e = e->next) {
+      if (e->size == sizeof(slot) && e->align == alignof(slot)) {
+        return static_cast<entry<slot>*>(e)->pool;
+      }
+    }
+    auto e = new entry<slot>(pools_);
+    pools_ = e;
+    return e->pool;
+  }
+
+  // Bytes of all slabs of all pools, slots in use or not and slab headers
+  // included (see dllist_pool<T>::capacity_bytes())...
+  std::size_t capacity_bytes() const noexcept {
+    std::size_t bytes = 0;
+    for (auto e = pools_; e != nullptr; e = e->next) {
+      bytes += e->capacity_bytes();
+    }
+    return bytes;
+  }
+};
+
+//===========================================================================
+//
+// dllist_pool_allocator<T, NodesPerSlab>
+//
+// An allocator whose instances share a single dllist_pool_resource. Copies
+// and rebound copies compare equal and share the resource; a default
+// constructed allocator starts a new one. Use it as
+// dllist<T, dllist_pool_allocator<T>> to give each list its own free list,
+// or construct several lists from one allocator to let them share a pool
+// (and splice() or merge() nodes between them without copying). Because
+// the pool travels with the list on swap/move, clear() and ~dllist() can
+// release whole slabs when the list is the resource's only user.
+//
+template <typename T, std::size_t NodesPerSlab>
+class dllist_pool_allocator {
+private:
+  template <typename, std::size_t>
+  friend class dllist_pool_allocator;
+
+  using resource_type = dllist_pool_resource<NodesPerSlab>;
+  using pool_type = typename resource_type::template pool_type<T>;
+  using slot_type = typename resource_type::template slot_type<T>;
+
+  std::shared_ptr<resource_type> resource_;
+  pool_type* pool_;     // resource_'s pool for T, looked up on first use
+
+  pool_type& pool() {
+    if (pool_ == nullptr) {
+      pool_ = &resource_->template pool<T>();
+    }
+    return *pool_;
+  }
+
+public:
+  using value_type = T;
+
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U>
+  struct rebind {
+    using other = dllist_pool_allocator<U, NodesPerSlab>;
+  };
+
+  dllist_pool_allocator() :
+    resource_(std::make_shared<resource_type>()), pool_(nullptr) {}
+
+  // A rebound copy shares the resource; it uses the resource's pool for
+  // its own slot size...
+  template <typename U>
+  dllist_pool_allocator(dllist_pool_allocator<U, NodesPerSlab> const& a) noexcept :
+    resource_(a.resource_), pool_(nullptr) {}
+
+  dllist_pool_allocator(dllist_pool_allocator const&) noexcept = default;
+  dllist_pool_allocator(dllist_pool_allocator&&) noexcept = default;
+  dllist_pool_allocator& operator =(dllist_pool_allocator const&) noexcept = default;
+  dllist_pool_allocator& operator =(dllist_pool_allocator&&) noexcept = default;
+  ~dllist_pool_allocator() = default;
+
+  T* allocate(std::size_t n) {
+    return reinterpret_cast<T*>(pool().allocate(n));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    pool().deallocate(reinterpret_cast<slot_type*>(p), n);
+  }
+
+  // A copied container gets its own resource...
+  dllist_pool_allocator select_on_container_copy_construction() const {
+    return dllist_pool_allocator{};
+  }
+
+  // See dllist_pool<T>::has_free()...
+  bool has_free() const noexcept {
+    return pool_ != nullptr && pool_->has_free();
+  }
+
+  // See dllist_pool_resource<N>::capacity_bytes(). This covers every pool
+  // of the resource, e.g., a list's node pool when called on the list's
+  // get_allocator().
+  std::size_t capacity_bytes() const noexcept {
+    return resource_->capacity_bytes();
+  }
+
+  // true if no other allocator (of any value type) shares this resource
+  bool unique() const noexcept {
+    return resource_.use_count() == 1;
+  }
+
+  // Free every slab of this allocator's pool at once. See
+  // dllist_pool<T>::release().
+  void release() noexcept {
+    if (pool_ != nullptr) {
+      pool_->release();
+    }
+  }
+
+  template <typename U, typename V, std::size_t N>
+  friend bool operator ==(dllist_pool_allocator<U, N> const&, dllist_pool_allocator<V, N> const&) noexcept;
+};
+
+template <typename T, typename U, std::size_t N>
+inline bool operator ==(dllist_pool_allocator<T, N> const& a, dllist_pool_allocator<U, N> const& b) noexcept {
+  return a.resource_ == b.resource_;
+}
+
+template <typename T, typename U, std::size_t N>
+inline bool operator !=(dllist_pool_allocator<T, N> const& a, dllist_pool_allocator<U, N> const& b) noexcept {
+  return !(a == b);
+}
+
+#endif // #ifndef DLLIST_POOL_HXX
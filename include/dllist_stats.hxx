@@ -0,0 +1,351 @@
+// The code here is to implement opt-in instrumentation for dllist<T>: a
+// Stats policy that counts allocations, resident memory, inserts, erases
+// and node visits per list, and a process-wide registry of those counters.
+
+#ifndef DLLIST_STATS_HXX
+#define DLLIST_STATS_HXX
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dllist.hxx"
+
+//===========================================================================
+//
+// dllist_stats_snapshot
+//
+// A copy of one list's counters. Node and byte counts cover the list's
+// nodes only (sizeof(dllist_node<T>) each); allocator overhead such as
+// partly used pool slabs is not included.
+//
+struct dllist_stats_snapshot {
+  std::uint64_t id;                   // registration order, from 1
+  std::string name;                   // set_name(), or empty
+  std::uint64_t nodes_allocated;      // nodes obtained from the allocator
+  std::uint64_t nodes_freed;          // nodes given back to the allocator
+  std::uint64_t nodes_resident;       // nodes currently owned by the list
+  std::uint64_t bytes_resident;       // bytes of those nodes
+  std::uint64_t peak_bytes_resident;  // highest bytes_resident seen
+  std::uint64_t inserts;              // elements added
+  std::uint64_t erases;               // elements removed
+  std::uint64_t visits;               // iterator ++ and -- calls
+};
+
+class dllist_counting_stats;
+
+//===========================================================================
+//
+// dllist_stats_registry
+//
+// Every live dllist_counting_stats is registered here. When a list is
+// destroyed its final counts are added to retired(), so the totals over
+// the whole process are kept even for short-lived lists (e.g., the
+// temporaries made by copy assignment). retired().peak_bytes_resident is
+// not a process-wide peak but a per-list maximum: the largest peak of any
+// one destroyed list. A list's peak includes nodes it received through
+// swap(), moves or splice(), so a list that briefly held another's nodes
+// can raise it.
+//
+class dllist_stats_registry
+{
+private:
+  mutable std::mutex mutex_;
+  std::vector<dllist_counting_stats const*> live_;
+  dllist_stats_snapshot retired_;
+  std::uint64_t next_id_;
+
+  friend class dllist_counting_stats;
+
+  dllist_stats_registry() :
+    live_(), retired_{ 0, "retired", 0, 0, 0, 0, 0, 0, 0, 0 }, next_id_(1) {}
+
+  std::uint64_t add(dllist_counting_stats const* s);
+  void remove(dllist_counting_stats const* s);
+
+  static void write_json_string(std::ostream& os, std::string const& str);
+  static void write_counts(std::ostream& os, dllist_stats_snapshot const& s);
+  static void write_json(std::ostream& os, dllist_stats_snapshot const& s);
+
+public:
+  dllist_stats_registry(dllist_stats_registry const&) = delete;
+  dllist_stats_registry& operator =(dllist_stats_registry const&) = delete;
+
+  static dllist_stats_registry& instance() {
+    static dllist_stats_registry registry;
+    return registry;
+  }
+
+  // snapshot() copies the counters of every live list, oldest first...
+  std::vector<dllist_stats_snapshot> snapshot() const;
+
+  // retired() is the sum of the counters of every destroyed list...
+  dllist_stats_snapshot retired() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return retired_;
+  }
+
+  // dump_text() writes one "dllist #id" line per live list and one
+  // "retired" line (which has no list id) for retired()...
+  void dump_text(std::ostream& os) const;
+
+  // dump_json() writes {"lists": [...], "retired": {...}}...
+  void dump_json(std::ostream& os) const;
+};
+
+//===========================================================================
+//
+// dllist_counting_stats
+//
+// The Stats policy for dllist<T, Alloc, dllist_counting_stats>. Each list
+// registers itself on construction and gets its own counters.
+//
+// A list is only used by one thread at a time, so each counter is updated
+// with a relaxed load and store instead of an atomic read-modify-write.
+// The counters are atomic only so that a snapshot taken from another
+// thread is well defined. Such a snapshot may be slightly stale, and
+// visits made through const iterators on several threads at once may be
+// undercounted.
+//
+class dllist_counting_stats
+{
+private:
+  using counter = std::atomic<std::uint64_t>;
+
+  counter nodes_allocated_;
+  counter nodes_freed_;
+  counter nodes_resident_;
+  counter bytes_resident_;
+  counter peak_bytes_resident_;
+  counter inserts_;
+  counter erases_;
+  mutable counter visits_;
+  std::string name_;                  // guarded by the registry's mutex
+  std::uint64_t id_;
+
+  friend class dllist_stats_registry;
+
+  static std::uint64_t get(counter const& c) {
+    return c.load(std::memory_order_relaxed);
+  }
+
+  static void add(counter& c, std::uint64_t n) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  static void sub(counter& c, std::uint64_t n) {
+    c.store(c.load(std::memory_order_relaxed) - n, std::memory_order_relaxed);
+  }
+
+  void gain(std::size_t nodes, std::size_t bytes) {
+    add(nodes_resident_, nodes);
+    add(bytes_resident_, bytes);
+    auto resident = get(bytes_resident_);
+    if (resident > get(peak_bytes_resident_)) {
+      peak_bytes_resident_.store(resident, std::memory_order_relaxed);
+    }
+  }
+
+  void lose(std::size_t nodes, std::size_t bytes) {
+    sub(nodes_resident_, nodes);
+    sub(bytes_resident_, bytes);
+  }
+
+public:
+  // Iterators hold a pointer to their list's visit counter...
+  class cursor {
+  private:
+    counter* visits_;
+
+  public:
+    cursor() : visits_(nullptr) {}
+    explicit cursor(counter* visits) : visits_(visits) {}
+
+    void visit() const {
+      if (visits_ != nullptr) {
+        add(*visits_, 1);
+      }
+    }
+  };
+
+  dllist_counting_stats() :
+    nodes_allocated_(0), nodes_freed_(0), nodes_resident_(0),
+    bytes_resident_(0), peak_bytes_resident_(0),
+    inserts_(0), erases_(0), visits_(0), name_(), id_(0)
+  {
+    id_ = dllist_stats_registry::instance().add(this);
+  }
+
+  ~dllist_counting_stats() {
+    dllist_stats_registry::instance().remove(this);
+  }
+
+  // Prohibitions...
+  dllist_counting_stats(dllist_counting_stats const&) = delete;
+  dllist_counting_stats& operator =(dllist_counting_stats const&) = delete;
+
+  // set_name() labels the list in snapshots and dumps...
+  void set_name(std::string name) {
+    std::lock_guard<std::mutex> lock(dllist_stats_registry::instance().mutex_);
+    name_ = std::move(name);
+  }
+
+  std::uint64_t id() const {
+    return id_;
+  }
+
+  std::uint64_t nodes_allocated() const { return get(nodes_allocated_); }
+  std::uint64_t nodes_freed() const { return get(nodes_freed_); }
+  std::uint64_t nodes_resident() const { return get(nodes_resident_); }
+  std::uint64_t bytes_resident() const { return get(bytes_resident_); }
+  std::uint64_t peak_bytes_resident() const { return get(peak_bytes_resident_); }
+  std::uint64_t inserts() const { return get(inserts_); }
+  std::uint64_t erases() const { return get(erases_); }
+  std::uint64_t visits() const { return get(visits_); }
+
+  // The hooks called by dllist<T, Alloc, Stats>...
+  cursor make_cursor() const {
+    return cursor(&visits_);
+  }
+
+  void on_allocate(std::size_t nodes, std::size_t bytes) {
+    add(nodes_allocated_, nodes);
+    gain(nodes, bytes);
+  }
+
+  void on_deallocate(std::size_t nodes, std::size_t bytes) {
+    add(nodes_freed_, nodes);
+    lose(nodes, bytes);
+  }
+
+  void on_insert(std::size_t n) {
+    add(inserts_, n);
+  }
+
+  void on_erase(std::size_t n) {
+    add(erases_, n);
+  }
+
+  void on_transfer(dllist_counting_stats& to, std::size_t nodes, std::size_t bytes) {
+    lose(nodes, bytes);
+    to.gain(nodes, bytes);
+  }
+
+  // The counters without the name (see dllist_stats_registry::snapshot())...
+  dllist_stats_snapshot counts() const {
+    return dllist_stats_snapshot{
+      id_, std::string(),
+      nodes_allocated(), nodes_freed(), nodes_resident(),
+      bytes_resident(), peak_bytes_resident(),
+      inserts(), erases(), visits()
+    };
+  }
+};
+
+//===========================================================================
+
+inline std::uint64_t dllist_stats_registry::add(dllist_counting_stats const* s) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  live_.push_back(s);
+  return next_id_++;
+}
+
+inline void dllist_stats_registry::remove(dllist_counting_stats const* s) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto c = s->counts();
+  retired_.nodes_allocated += c.nodes_allocated;
+  retired_.nodes_freed += c.nodes_freed;
+  retired_.nodes_resident += c.nodes_resident;
+  retired_.bytes_resident += c.bytes_resident;
+  retired_.peak_bytes_resident = std::max(retired_.peak_bytes_resident, c.peak_bytes_resident);
+  retired_.inserts += c.inserts;
+  retired_.erases += c.erases;
+  retired_.visits += c.visits;
+  for (auto i = live_.begin(); i != live_.end(); ++i) {
+    if (*i == s) {
+      live_.erase(i);
+      break;
+    }
+  }
+}
+
+inline std::vector<dllist_stats_snapshot> dllist_stats_registry::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<dllist_stats_snapshot> result;
+  result.reserve(live_.size());
+  for (auto s : live_) {
+    result.push_back(s->counts());
+    result.back().name = s->name_;
+  }
+  return result;
+}
+
+// write_counts() writes the ": allocated ..., visits n" part of a line...
+inline void dllist_stats_registry::write_counts(std::ostream& os, dllist_stats_snapshot const& s) {
+  os << ": allocated " << s.nodes_allocated
+     << ", freed " << s.nodes_freed
+     << ", resident " << s.nodes_resident << " nodes / " << s.bytes_resident << " bytes"
+     << ", peak " << s.peak_bytes_resident << " bytes"
+     << ", inserts " << s.inserts
+     << ", erases " << s.erases
+     << ", visits " << s.visits << '\n';
+}
+
+inline void dllist_stats_registry::dump_text(std::ostream& os) const {
+  for (auto const& s : snapshot()) {
+    os << "dllist #" << s.id;
+    if (!s.name.empty()) {
+      os << " (" << s.name << ')';
+    }
+    write_counts(os, s);
+  }
+  os << "retired";
+  write_counts(os, retired());
+}
+
+inline void dllist_stats_registry::write_json_string(std::ostream& os, std::string const& str) {
+  static char const hex[] = "0123456789abcdef";
+  os << '"';
+  for (unsigned char ch : str) {
+    if (ch == '"' || ch == '\\') {
+      os << '\\' << ch;
+    } else if (ch < 0x20) {
+      os << "\\u00" << hex[ch >> 4] << hex[ch & 0xf];
+    } else {
+      os << ch;
+    }
+  }
+  os << '"';
+}
+
+inline void dllist_stats_registry::write_json(std::ostream& os, dllist_stats_snapshot const& s) {
+  os << "{\"id\": " << s.id << ", \"name\": ";
+  write_json_string(os, s.name);
+  os << ", \"nodes_allocated\": " << s.nodes_allocated
+     << ", \"nodes_freed\": " << s.nodes_freed
+     << ", \"nodes_resident\": " << s.nodes_resident
+     << ", \"bytes_resident\": " << s.bytes_resident
+     << ", \"peak_bytes_resident\": " << s.peak_bytes_resident
+     << ", \"inserts\": " << s.inserts
+     << ", \"erases\": " << s.erases
+     << ", \"visits\": " << s.visits << '}';
+}
+
+inline void dllist_stats_registry::dump_json(std::ostream& os) const {
+  auto lists = snapshot();
+  os << "{\"lists\": [";
+  for (std::size_t i = 0; i != lists.size(); ++i) {
+    os << (i != 0 ? ",\n  " : "\n  ");
+    write_json(os, lists[i]);
+  }
+  os << (lists.empty() ? "" : "\n") << "], \"retired\": ";
+  write_json(os, retired());
+  os << "}\n";
+}
+
+#endif // #ifndef DLLIST_STATS_HXX
@@ -0,0 +1,816 @@
+// The code here is to implement an unrolled XOR-encoded doubly-linked list,
+// i.e., a list whose nodes ("blocks") each hold up to N elements.
+
+#ifndef UNROLLED_DLLIST_HXX
+#define UNROLLED_DLLIST_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "dllist.hxx"
+
+// unrolled_dllist_default_capacity<T>::value is the number of T that fit
+// in one 64-byte cache line next to a block's link and element count.
+template <typename T>
+struct unrolled_dllist_default_capacity {
+  static constexpr std::size_t cache_line = 64;
+  static constexpr std::size_t overhead = sizeof(void*) + sizeof(std::size_t);
+  static constexpr std::size_t value =
+    sizeof(T) + overhead <= cache_line ? (cache_line - overhead) / sizeof(T) : 1;
+};
+
+template <typename T, std::size_t N>
+class unrolled_dllist_block;    // unrolled list node type
+
+template <
+  typename T,
+  std::size_t N = unrolled_dllist_default_capacity<T>::value,
+  typename Alloc = std::allocator<T>
+>
+class unrolled_dllist;          // unrolled list container type
+
+template <typename T, std::size_t N>
+class unrolled_dllist_iter;     // unrolled list iterator type
+
+template <typename T, std::size_t N>
+class unrolled_dllist_citer;    // unrolled list const_iterator type
+
+//===========================================================================
+//
+// unrolled_dllist_block<T, N>
+//
+// A block is an XOR-linked node (it inherits the link from
+// dllist_node_ptr_only, exactly like dllist_node<T>) that stores up to N
+// elements contiguously. Elements [0, size()) are constructed; the rest
+// of the storage is raw.
+//
+template <typename T, std::size_t N>
+class unrolled_dllist_block final :
+  public dllist_node_ptr_only<unrolled_dllist_block<T, N>>
+{
+public:
+  using link_type = dllist_node_ptr_only<unrolled_dllist_block>;
+
+private:
+  static_assert(N > 0, "an unrolled_dllist block must hold at least one element");
+
+  std::size_t count_;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type data_[N];
+
+public:
+  unrolled_dllist_block() :
+    link_type(nullptr, nullptr), count_(0) {}
+
+  // Prohibitions...
+  unrolled_dllist_block(unrolled_dllist_block const&) = delete;
+  unrolled_dllist_block& operator =(unrolled_dllist_block const&) = delete;
+
+  ~unrolled_dllist_block() {
+    clear();
+  }
+
+  std::size_t size() const {
+    return count_;
+  }
+
+  bool full() const {
+    return count_ == N;
+  }
+
+  T* data() {
+    return reinterpret_cast<T*>(data_);
+  }
+
+  T const* data() const {
+    return reinterpret_cast<T const*>(data_);
+  }
+
+  // Insert value at index i, shifting [i, size()) up by one...
+  void insert(std::size_t i, T&& value) {
+    T* d = data();
+    if (i == count_) {
+      ::new (static_cast<void*>(d + count_)) T(std::move(value));
+    } else {
+      ::new (static_cast<void*>(d + count_)) T(std::move(d[count_ - 1]));
+      for (std::size_t j = count_ - 1; j != i; --j) {
+        d[j] = std::move(d[j - 1]);
+      }
+      d[i] = std::move(value);
+    }
+    ++count_;
+  }
+
+  // Erase the element at index i, shifting (i, size()) down by one...
+  void erase(std::size_t i) {
+    T* d = data();
+    std::move(d + i + 1, d + count_, d + i);
+    --count_;
+    d[count_].~T();
+  }
+
+  // Move elements [i, size()) to the end of b...
+  void move_tail(std::size_t i, unrolled_dllist_block& b) {
+    T* d = data();
+    T* bd = b.data();
+    for (std::size_t j = i; j != count_; ++j) {
+      ::new (static_cast<void*>(bd + b.count_)) T(std::move(d[j]));
+      ++b.count_;
+      d[j].~T();
+    }
+    count_ = i;
+  }
+
+  void clear() {
+    T* d = data();
+    while (count_ != 0) {
+      --count_;
+      d[count_].~T();
+    }
+  }
+};
+
+//===========================================================================
+//
+// unrolled_dllist<T, N, Alloc>
+//
+// An XOR-encoded doubly-linked list of blocks of up to N elements. It uses
+// the same front_/back_ sentinel scheme as dllist<T>. Its iterator, insert
+// and erase API follow dllist<T>. A full block is split in two on insert.
+// A block that is at most half full after an erase is merged with a
+// neighbour whenever both fit in one block.
+//
+// As with std::deque, insert and erase invalidate all iterators except the
+// one they return.
+//
+template <typename T, std::size_t N, typename Alloc>
+class unrolled_dllist
+{
+private:
+  using block_type = unrolled_dllist_block<T, N>;
+  using link_type = typename block_type::link_type;
+  using block_allocator_type =
+    typename std::allocator_traits<Alloc>::template rebind_alloc<block_type>;
+  using block_alloc_traits = std::allocator_traits<block_allocator_type>;
+
+  std::size_t size_;              // number of elements (not blocks)
+  link_type front_;               // sentinel "front" node
+  link_type back_;                // sentinel "back" node
+  block_allocator_type alloc_;    // source of all blocks
+
+  static block_type* to_block(link_type* p) {
+    return static_cast<block_type*>(p);
+  }
+
+  block_type* create_block() {
+    block_type* p = block_alloc_traits::allocate(alloc_, 1);
+    try {
+      block_alloc_traits::construct(alloc_, p);
+    } catch (...) {
+      block_alloc_traits::deallocate(alloc_, p, 1);
+      throw;
+    }
+    return p;
+  }
+
+  void destroy_block(link_type* p) {
+    block_type* b = to_block(p);
+    block_alloc_traits::destroy(alloc_, b);
+    block_alloc_traits::deallocate(alloc_, b, 1);
+  }
+
+  // Link a new, empty block after cur (whose predecessor is prev)...
+  block_type* insert_block_after(link_type* prev, link_type* cur) {
+    block_type* b = create_block();
+    link_type::insert(prev, cur, b);
+    return b;
+  }
+
+  // Unlink and free cur (whose predecessor is prev)...
+  void erase_block(link_type* prev, link_type* cur) {
+    destroy_block(link_type::remove(prev->nextptr(cur), prev));
+  }
+
+  void swap_allocators(unrolled_dllist& l, std::true_type) {
+    using std::swap;
+    swap(alloc_, l.alloc_);
+  }
+
+  void swap_allocators(unrolled_dllist&, std::false_type) {
+  }
+
+  // Enable the iterator-range overloads only for iterator types so that,
+  // e.g., unrolled_dllist<int>(6, 10) still selects the (n, value) overload.
+  template <typename InIter>
+  using enable_if_iterator = typename std::enable_if<
+    !std::is_integral<InIter>::value,
+    typename std::iterator_traits<InIter>::iterator_category
+  >::type;
+
+public:
+  using value_type = T;
+  using allocator_type = Alloc;
+
+  using reference = value_type&;
+  using const_reference = value_type const&;
+
+  using pointer = value_type*;
+  using const_pointer = value_type const*;
+
+  using iterator = unrolled_dllist_iter<T, N>;
+  using const_iterator = unrolled_dllist_citer<T, N>;
+
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr size_type block_capacity = N;
+
+  // Default constructor...
+  unrolled_dllist() :
+    size_(0), front_(&back_, &back_), back_(&front_, &front_), alloc_() {}
+
+  explicit unrolled_dllist(allocator_type const& a) :
+    size_(0), front_(&back_, &back_), back_(&front_, &front_), alloc_(a) {}
+
+  unrolled_dllist(size_type n, T const& value = T{}) : unrolled_dllist{} {
+    std::fill_n(std::back_inserter(*this), n, value);
+  }
+
+  unrolled_dllist(std::initializer_list<T> il) : unrolled_dllist{} {
+    std::copy(il.begin(), il.end(), std::back_inserter(*this));
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  unrolled_dllist(InIter const& first, InIter const& last) : unrolled_dllist{} {
+    std::copy(first, last, std::back_inserter(*this));
+  }
+
+  unrolled_dllist(unrolled_dllist const& l) :
+    unrolled_dllist{allocator_type(block_alloc_traits::select_on_container_copy_construction(l.alloc_))}
+  {
+    std::copy(l.begin(), l.end(), std::back_inserter(*this));
+  }
+
+  unrolled_dllist(unrolled_dllist&& l) :
+    unrolled_dllist{}
+  {
+    swap(l);
+  }
+
+  ~unrolled_dllist() {
+    clear();
+  }
+
+  unrolled_dllist& operator =(unrolled_dllist const& l) {
+    unrolled_dllist tmp(l);
+    this->swap(tmp);
+    return *this;
+  }
+
+  unrolled_dllist& operator =(unrolled_dllist&& l) {
+    unrolled_dllist tmp(std::move(l));
+    this->swap(tmp);
+    return *this;
+  }
+
+  void assign(std::initializer_list<T> il) {
+    unrolled_dllist tmp(il);
+    this->swap(tmp);
+  }
+
+  void assign(size_type n, value_type const& value) {
+    unrolled_dllist tmp(n, value);
+    this->swap(tmp);
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  void assign(InIter const& first, InIter const& last) {
+    unrolled_dllist tmp(first, last);
+    this->swap(tmp);
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(alloc_);
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_type size() const {
+    return size_;
+  }
+
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max();
+  }
+
+  // block_count() is the number of blocks (nodes) in the list. O(blocks).
+  size_type block_count() const {
+    size_type n = 0;
+    link_type const* prev = &front_;
+    link_type const* cur = front_.nextptr(&back_);
+    while (cur != &back_) {
+      auto next = cur->nextptr(prev);
+      prev = cur;
+      cur = next;
+      ++n;
+    }
+    return n;
+  }
+
+  reference front() {
+    return to_block(front_.nextptr(&back_))->data()[0];
+  }
+
+  const_reference front() const {
+    return static_cast<block_type const*>(front_.nextptr(&back_))->data()[0];
+  }
+
+  reference back() {
+    auto b = to_block(back_.nextptr(&front_));
+    return b->data()[b->size() - 1];
+  }
+
+  const_reference back() const {
+    auto b = static_cast<block_type const*>(back_.nextptr(&front_));
+    return b->data()[b->size() - 1];
+  }
+
+  iterator begin() {
+    return iterator(&front_, front_.nextptr(&back_), 0);
+  }
+
+  iterator end() {
+    return iterator(back_.nextptr(&front_), &back_, 0);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(&front_, front_.nextptr(&back_), 0);
+  }
+
+  const_iterator end() const {
+    return const_iterator(back_.nextptr(&front_), &back_, 0);
+  }
+
+  const_iterator cbegin() const {
+    return begin();
+  }
+
+  const_iterator cend() const {
+    return end();
+  }
+
+  reverse_iterator rbegin() {
+    return reverse_iterator(this->end());
+  }
+
+  reverse_iterator rend() {
+    return reverse_iterator(this->begin());
+  }
+
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(this->end());
+  }
+
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(this->begin());
+  }
+
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(this->cend());
+  }
+
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(this->cbegin());
+  }
+
+  // clear() destroys all elements and frees all blocks
+  void clear() {
+    link_type* prev = &front_;
+    link_type* cur = front_.nextptr(&back_);
+    while (cur != &back_) {
+      link_type* next = cur->nextptr(prev);
+      destroy_block(cur);
+      prev = cur;
+      cur = next;
+    }
+    front_.setptr(&back_, &back_);
+    back_.setptr(&front_, &front_);
+    size_ = 0;
+  }
+
+  // Only the end blocks of each chain refer to the sentinels, so swapping
+  // rewires those (at most) four links and the sentinels themselves.
+  void swap(unrolled_dllist& l) {
+    link_type* first = front_.nextptr(&back_);
+    link_type* last = back_.nextptr(&front_);
+    link_type* l_first = l.front_.nextptr(&l.back_);
+    link_type* l_last = l.back_.nextptr(&l.front_);
+
+    if (first != &back_) {
+      first->updateptr(&front_, &l.front_);
+      last->updateptr(&back_, &l.back_);
+      l.front_.setptr(&l.back_, first);
+      l.back_.setptr(last, &l.front_);
+    } else {
+      l.front_.setptr(&l.back_, &l.back_);
+      l.back_.setptr(&l.front_, &l.front_);
+    }
+
+    if (l_first != &l.back_) {
+      l_first->updateptr(&l.front_, &front_);
+      l_last->updateptr(&l.back_, &back_);
+      front_.setptr(&back_, l_first);
+      back_.setptr(l_last, &front_);
+    } else {
+      front_.setptr(&back_, &back_);
+      back_.setptr(&front_, &front_);
+    }
+
+    std::swap(size_, l.size_);
+    swap_allocators(l, typename block_alloc_traits::propagate_on_container_swap{});
+  }
+
+  void push_front(value_type const& v) {
+    emplace(begin(), v);
+  }
+
+  void push_front(value_type&& v) {
+    emplace(begin(), std::move(v));
+  }
+
+  void pop_front() {
+    erase(begin());
+  }
+
+  void push_back(value_type const& v) {
+    emplace(end(), v);
+  }
+
+  void push_back(value_type&& v) {
+    emplace(end(), std::move(v));
+  }
+
+  void pop_back() {
+    erase(--end());
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    T value(std::forward<Args>(args)...);
+
+    link_type* prev = const_cast<link_type*>(pos.prevptr_);
+    link_type* cur = const_cast<link_type*>(pos.nodeptr_);
+    std::size_t i = pos.index_;
+
+    // Inserting at a block boundary: prefer the end of the previous block.
+    if (i == 0 && prev != &front_ && !to_block(prev)->full()) {
+      link_type* prev_prev = prev->nextptr(cur);
+      cur = prev;
+      prev = prev_prev;
+      i = to_block(cur)->size();
+    } else if (cur == &back_) {
+      link_type* prev_prev = prev->nextptr(cur);
+      cur = insert_block_after(prev_prev, prev);
+    } else if (to_block(cur)->full()) {
+      block_type* b = to_block(cur);
+      block_type* next = insert_block_after(prev, cur);
+
+      // Split: keep the lower half here, move the upper half to next...
+      std::size_t keep = N / 2;
+      b->move_tail(keep, *next);
+      if (i > keep) {
+        prev = cur;
+        cur = next;
+        i -= keep;
+      }
+    }
+
+    to_block(cur)->insert(i, std::move(value));
+    ++size_;
+    return iterator(prev, cur, i);
+  }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    this->emplace(begin(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    this->emplace(end(), std::forward<Args>(args)...);
+  }
+
+  iterator insert(const_iterator pos, value_type const& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, value_type&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // The multi-element inserts return an iterator to the first inserted
+  // element (or pos if nothing was inserted).
+  iterator insert(const_iterator pos, size_type n, value_type const& value) {
+    if (n == 0) {
+      return iterator(
+        const_cast<link_type*>(pos.prevptr_),
+        const_cast<link_type*>(pos.nodeptr_),
+        pos.index_
+      );
+    }
+    iterator i = emplace(pos, value);
+    for (size_type k = 1; k != n; ++k) {
+      i = emplace(++i, value);
+    }
+    // Later inserts may have split blocks, so step back from the last one...
+    return std::prev(i, static_cast<difference_type>(n - 1));
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> il) {
+    return insert(pos, il.begin(), il.end());
+  }
+
+  template <typename InIter, typename = enable_if_iterator<InIter>>
+  iterator insert(const_iterator pos, InIter first, InIter const& last) {
+    if (first == last) {
+      return iterator(
+        const_cast<link_type*>(pos.prevptr_),
+        const_cast<link_type*>(pos.nodeptr_),
+        pos.index_
+      );
+    }
+    iterator i = emplace(pos, *first);
+    difference_type n = 0;
+    for (++first; first != last; ++first, ++n) {
+      i = emplace(++i, *first);
+    }
+    // Later inserts may have split blocks, so step back from the last one...
+    return std::prev(i, n);
+  }
+
+  iterator erase(const_iterator pos) {
+    link_type* prev = const_cast<link_type*>(pos.prevptr_);
+    link_type* cur = const_cast<link_type*>(pos.nodeptr_);
+    std::size_t i = pos.index_;
+    block_type* b = to_block(cur);
+
+    b->erase(i);
+    --size_;
+
+    link_type* next = cur->nextptr(prev);
+    if (b->size() == 0) {
+      erase_block(prev, cur);
+      return iterator(prev, next, 0);
+    }
+
+    // A block that is at most half full is merged with a neighbour whenever
+    // both fit in one block, so erasing, e.g., every other element leaves
+    // full blocks rather than half-empty ones. Try its successor first...
+    if (b->size() <= N / 2 && next != &back_ && b->size() + to_block(next)->size() <= N) {
+      to_block(next)->move_tail(0, *b);
+      erase_block(cur, next);
+      return iterator(prev, cur, i);
+    }
+
+    // ...then its predecessor.
+    if (b->size() <= N / 2 && prev != &front_ && b->size() + to_block(prev)->size() <= N) {
+      block_type* p = to_block(prev);
+      std::size_t offset = p->size();
+      b->move_tail(0, *p);
+      link_type* prev_prev = prev->nextptr(cur);
+      erase_block(prev, cur);
+      if (offset + i < p->size()) {
+        return iterator(prev_prev, prev, offset + i);
+      }
+      return iterator(prev, next, 0);
+    }
+
+    if (i == b->size()) {
+      return iterator(cur, next, 0);
+    }
+    return iterator(prev, cur, i);
+  }
+
+  // Erasing may merge blocks, which would invalidate last, so count first.
+  iterator erase(const_iterator first, const_iterator const& last) {
+    auto n = std::distance(first, last);
+    iterator i(
+      const_cast<link_type*>(first.prevptr_),
+      const_cast<link_type*>(first.nodeptr_),
+      first.index_
+    );
+    for (; n != 0; --n) {
+      i = erase(i);
+    }
+    return i;
+  }
+};
+
+template <typename T, std::size_t N, typename Alloc>
+constexpr typename unrolled_dllist<T, N, Alloc>::size_type unrolled_dllist<T, N, Alloc>::block_capacity;
+
+//===========================================================================
+
+template <typename T, std::size_t N, typename Alloc>
+inline void swap(unrolled_dllist<T, N, Alloc>& a, unrolled_dllist<T, N, Alloc>& b)
+{
+  a.swap(b);
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator ==(unrolled_dllist<T, N, Alloc> const& a, unrolled_dllist<T, N, Alloc> const& b)
+{
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator !=(unrolled_dllist<T, N, Alloc> const& a, unrolled_dllist<T, N, Alloc> const& b)
+{
+  return !(a == b);
+}
+
+//===========================================================================
+//
+// unrolled_dllist_iter<T, N>
+//
+// Like dllist_iter<T>, the iterator remembers the previous node to decode
+// the XOR link; in addition it holds the element index within the block.
+//
+template <typename T, std::size_t N>
+class unrolled_dllist_iter : public std::iterator<std::bidirectional_iterator_tag, T, std::ptrdiff_t, T*, T&> {
+private:
+  template <typename, std::size_t, typename> friend class unrolled_dllist;
+  friend class unrolled_dllist_citer<T, N>;
+
+  using block_type = unrolled_dllist_block<T, N>;
+  using link_type = typename block_type::link_type;
+
+  link_type* prevptr_;    // Used to compute next block address
+  link_type* nodeptr_;    // Current block
+  std::size_t index_;     // Element index within *nodeptr_
+
+  block_type* block() const {
+    return static_cast<block_type*>(nodeptr_);
+  }
+
+public:
+  unrolled_dllist_iter() :
+    prevptr_{nullptr}, nodeptr_{nullptr}, index_{0} {}
+
+  unrolled_dllist_iter(link_type* prev, link_type* cur, std::size_t index) :
+    prevptr_{prev}, nodeptr_{cur}, index_{index} {}
+
+  bool operator ==(unrolled_dllist_iter const& i) const {
+    return nodeptr_ == i.nodeptr_ && index_ == i.index_;
+  }
+
+  bool operator !=(unrolled_dllist_iter const& i) const {
+    return !(operator==(i));
+  }
+
+  T& operator *() const {
+    return block()->data()[index_];
+  }
+
+  T* operator ->() const {
+    return block()->data() + index_;
+  }
+
+  unrolled_dllist_iter& operator ++() {
+    if (++index_ == block()->size()) {
+      auto next_nodeptr_ = nodeptr_->nextptr(prevptr_);
+      prevptr_ = nodeptr_;
+      nodeptr_ = next_nodeptr_;
+      index_ = 0;
+    }
+    return *this;
+  }
+
+  unrolled_dllist_iter operator ++(int) {
+    unrolled_dllist_iter tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  unrolled_dllist_iter& operator --() {
+    if (index_ == 0) {
+      auto prev_prevptr_ = prevptr_->nextptr(nodeptr_);
+      nodeptr_ = prevptr_;
+      prevptr_ = prev_prevptr_;
+      index_ = block()->size();
+    }
+    --index_;
+    return *this;
+  }
+
+  unrolled_dllist_iter operator --(int) {
+    unrolled_dllist_iter tmp(*this);
+    operator--();
+    return tmp;
+  }
+};
+
+//===========================================================================
+//
+// unrolled_dllist_citer<T, N>
+//
+template <typename T, std::size_t N>
+class unrolled_dllist_citer : public std::iterator<std::bidirectional_iterator_tag, T const, std::ptrdiff_t, T const*, T const&> {
+private:
+  template <typename, std::size_t, typename> friend class unrolled_dllist;
+
+  using block_type = unrolled_dllist_block<T, N>;
+  using link_type = typename block_type::link_type;
+
+  link_type const* prevptr_;
+  link_type const* nodeptr_;
+  std::size_t index_;
+
+  block_type const* block() const {
+    return static_cast<block_type const*>(nodeptr_);
+  }
+
+public:
+  unrolled_dllist_citer() :
+    prevptr_{nullptr}, nodeptr_{nullptr}, index_{0} {}
+
+  unrolled_dllist_citer(link_type const* prev, link_type const* cur, std::size_t index) :
+    prevptr_{prev}, nodeptr_{cur}, index_{index} {}
+
+  unrolled_dllist_citer(unrolled_dllist_iter<T, N> const& i) :
+    prevptr_{i.prevptr_}, nodeptr_{i.nodeptr_}, index_{i.index_} {}
+
+  bool operator ==(unrolled_dllist_citer const& i) const {
+    return nodeptr_ == i.nodeptr_ && index_ == i.index_;
+  }
+
+  bool operator !=(unrolled_dllist_citer const& i) const {
+    return !(operator==(i));
+  }
+
+  T const& operator *() const {
+    return block()->data()[index_];
+  }
+
+  T const* operator ->() const {
+    return block()->data() + index_;
+  }
+
+  unrolled_dllist_citer& operator ++() {
+    if (++index_ == block()->size()) {
+      auto next_nodeptr_ = nodeptr_->nextptr(prevptr_);
+      prevptr_ = nodeptr_;
+      nodeptr_ = next_nodeptr_;
+      index_ = 0;
+    }
+    return *this;
+  }
+
+  unrolled_dllist_citer operator ++(int) {
+    unrolled_dllist_citer tmp(*this);
+    operator++();
+    return tmp;
+  }
+
+  unrolled_dllist_citer& operator --() {
+    if (index_ == 0) {
+      auto prev_prevptr_ = prevptr_->nextptr(nodeptr_);
+      nodeptr_ = prevptr_;
+      prevptr_ = prev_prevptr_;
+      index_ = block()->size();
+    }
+    --index_;
+    return *this;
+  }
+
+  unrolled_dllist_citer operator --(int) {
+    unrolled_dllist_citer tmp(*this);
+    operator--();
+    return tmp;
+  }
+};
+
+template <typename T, std::size_t N>
+inline bool operator ==(unrolled_dllist_iter<T, N> const& i, unrolled_dllist_citer<T, N> const& j)
+{
+  return j == i;
+}
+
+template <typename T, std::size_t N>
+inline bool operator !=(unrolled_dllist_iter<T, N> const& i, unrolled_dllist_citer<T, N> const& j)
+{
+  return j != i;
+}
+
+#endif // #ifndef UNROLLED_DLLIST_HXX
@@ -2,24 +2,53 @@
 #define XORPTR_HXX
 
 
+#include <cstdint>
+
+// Encodings...
+//
+// An encoding tag selects how xorptr_traits<T, Encoding> combines two
+// pointer values. The choice is made at compile time through the
+// Encoding template argument (see xorptr_default_encoding below).
+//
+//   xorptr_uintptr_encoding    XOR the two addresses as one std::uintptr_t
+//                              word held in a register (default).
+//   xorptr_bytewise_encoding   XOR the addresses one byte at a time
+//                              through volatile void* locals (legacy).
+//   xorptr_index32_encoding    XOR two 32-bit node indices into an arena
+//                              instead of two addresses (see
+//                              arena_dllist<T>). Indices have no
+//                              const/non-const forms, so this encoding is
+//                              used through xorptr_traits, not xorptr<T>.
+struct xorptr_uintptr_encoding final {};
+struct xorptr_bytewise_encoding final {};
+struct xorptr_index32_encoding final {};
+
+// The default encoding is xorptr_uintptr_encoding. The historical macros
+// are still honoured: defining CXX_XOR_PROJECT_USE_REINTERPRET_CAST makes
+// the byte-wise encoding the default.
 #if defined CXX_XOR_PROJECT_USE_REINTERPRET_CAST && defined CXX_XOR_PROJECT_USE_UINTPTR_T
 #error "Only define one CXX_XOR_PROJECT_USE_XXX macro!"
-#elif !defined CXX_XOR_PROJECT_USE_REINTERPRET_CAST  && !defined CXX_XOR_PROJECT_USE_UINTPTR_T
-#error "Define one of the CXX_XOR_PROJECT_USE_XXX macros!"
+#elif defined CXX_XOR_PROJECT_USE_REINTERPRET_CAST
+using xorptr_default_encoding = xorptr_bytewise_encoding;
+#else
+using xorptr_default_encoding = xorptr_uintptr_encoding;
 #endif
 
-#ifdef CXX_XOR_PROJECT_USE_UINTPTR_T 
-#define xorptr_traits_defined true
+template <typename T, typename Encoding = xorptr_default_encoding>
+struct xorptr_traits;
+
 template <typename T>
-struct xorptr_traits final {
+struct xorptr_traits<T, xorptr_uintptr_encoding> final {
   using pointer_type = T*;
   using const_pointer_type = T const*;
   using xorptr_type = std::uintptr_t;
 
-  static xorptr_type create() noexcept {
-    return create(static_cast<T*>(nullptr), static_cast<T*>(nullptr));
+  // Create an XOR-encoded pointer value of two nullptr values...
+  static constexpr xorptr_type create() noexcept {
+    return 0;
   }
 
+  // Create an XOR-encoded pointer value of two pointer values...
   static xorptr_type create(pointer_type p1, pointer_type p2) noexcept {
     return reinterpret_cast<std::uintptr_t>(p1) ^ reinterpret_cast<std::uintptr_t>(p2);
   }
@@ -28,22 +57,42 @@ struct xorptr_traits final {
     return reinterpret_cast<std::uintptr_t>(p1) ^ reinterpret_cast<std::uintptr_t>(p2);
   }
 
+  // Compute the XOR of an XOR-encoded pointer with a normal pointer...
   static pointer_type extract(xorptr_type const& xp, pointer_type p) noexcept {
-    return static_cast<T*>(reinterpret_cast<void*>(xp ^ reinterpret_cast<std::uintptr_t>(p)));
+    return reinterpret_cast<pointer_type>(xp ^ reinterpret_cast<std::uintptr_t>(p));
   }
 
   static const_pointer_type extract(xorptr_type const& xp, const_pointer_type p) noexcept {
-    return static_cast<T const*>(reinterpret_cast<void const*>(xp ^ reinterpret_cast<std::uintptr_t>(p)));
+    return reinterpret_cast<const_pointer_type>(xp ^ reinterpret_cast<std::uintptr_t>(p));
   }
-};
-#endif
 
+#if defined __GNUC__
+  // Atomic variants for an xorptr_type shared between threads (see
+  // concurrent_dllist<T>). They use the __atomic builtins on the plain
+  // word so that the layout of xorptr<T> is the same as above.
+  //
+  // atomic_extract() is an acquire load followed by extract()...
+  static pointer_type atomic_extract(xorptr_type const& xp, pointer_type p) noexcept {
+    return reinterpret_cast<pointer_type>(
+      __atomic_load_n(&xp, __ATOMIC_ACQUIRE) ^ reinterpret_cast<std::uintptr_t>(p));
+  }
 
-#ifdef CXX_XOR_PROJECT_USE_REINTERPRET_CAST
-#define xorptr_traits_defined true
+  // atomic_update() replaces oldp by newp with a single fetch_xor, so
+  // concurrent updates of the two halves of xp commute...
+  static void atomic_update(xorptr_type& xp, pointer_type oldp, pointer_type newp) noexcept {
+    __atomic_fetch_xor(&xp,
+      reinterpret_cast<std::uintptr_t>(oldp) ^ reinterpret_cast<std::uintptr_t>(newp),
+      __ATOMIC_ACQ_REL);
+  }
+
+  static void atomic_store(xorptr_type& xp, pointer_type p1, pointer_type p2) noexcept {
+    __atomic_store_n(&xp, create(p1, p2), __ATOMIC_RELEASE);
+  }
+#endif
+};
 
 template <typename T>
-struct xorptr_traits final {
+struct xorptr_traits<T, xorptr_bytewise_encoding> final {
   using pointer_type = T*;
   using const_pointer_type = T const*;
   using xorptr_type = void*;
@@ -102,20 +151,44 @@ struct xorptr_traits final {
     return static_cast<const_pointer_type>(vp1);
   }
 };
-#endif
 
-#ifdef xorptr_traits_defined
+// Here a "pointer" is the index of a T in an array (the arena). The
+// links do not depend on where the arena is, so it may be moved, copied
+// with memcpy() or mapped at different addresses.
 template <typename T>
+struct xorptr_traits<T, xorptr_index32_encoding> final {
+  using pointer_type = std::uint32_t;
+  using const_pointer_type = std::uint32_t;
+  using xorptr_type = std::uint32_t;
+
+  // Create an XOR-encoded index of two index 0 values...
+  static constexpr xorptr_type create() noexcept {
+    return 0;
+  }
+
+  // Create an XOR-encoded index of two indices...
+  static constexpr xorptr_type create(pointer_type i1, pointer_type i2) noexcept {
+    return i1 ^ i2;
+  }
+
+  // Compute the XOR of an XOR-encoded index with a normal index...
+  static constexpr pointer_type extract(xorptr_type xp, pointer_type i) noexcept {
+    return xp ^ i;
+  }
+};
+
+template <typename T, typename Encoding = xorptr_default_encoding>
 class xorptr final {
 public:
-  using traits_type = xorptr_traits<T>;
+  using encoding_type = Encoding;
+  using traits_type = xorptr_traits<T, Encoding>;
   using pointer_type = typename traits_type::pointer_type;
   using const_pointer_type = typename traits_type::const_pointer_type;
 private:
   using xorptr_type = typename traits_type::xorptr_type;
   xorptr_type xorptr_;
 public:
-  xorptr() noexcept : 
+  constexpr xorptr() noexcept :
     xorptr_(traits_type::create()) {}
   explicit xorptr(pointer_type ptr1, pointer_type ptr2) noexcept : 
     xorptr_(traits_type::create(ptr1, ptr2)) {}
@@ -132,7 +205,25 @@ public:
   const_pointer_type operator ^(const_pointer_type& b) const noexcept {
     return traits_type::extract(xorptr_, b);
   }
+  // Atomic access, only for encodings whose traits provide it...
+  pointer_type atomic_extract(pointer_type b) const noexcept {
+    return traits_type::atomic_extract(xorptr_, b);
+  }
+  void atomic_update(pointer_type oldptr, pointer_type newptr) noexcept {
+    traits_type::atomic_update(xorptr_, oldptr, newptr);
+  }
+  void atomic_store(pointer_type ptr1, pointer_type ptr2) noexcept {
+    traits_type::atomic_store(xorptr_, ptr1, ptr2);
+  }
+};
+
+// Indices have a single (non-const) form, so xorptr<T>'s pointer and
+// const pointer constructors would clash. Use
+// xorptr_traits<T, xorptr_index32_encoding> directly instead.
+template <typename T>
+class xorptr<T, xorptr_index32_encoding> final {
+  static_assert(sizeof(T) == 0,
+    "xorptr_index32_encoding is used through xorptr_traits, not xorptr<T>");
 };
-#endif
 
 #endif // #ifndef XORPTR_HXX
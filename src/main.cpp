@@ -1,7 +1,15 @@
+#include <cassert>
 #include <iostream>
-// #define CXX_XOR_PROJECT_USE_UINTPTR_T 1
-#define CXX_XOR_PROJECT_USE_REINTERPRET_CAST 1
 #include "dllist.hxx"
+#include "dllist_pool.hxx"
+#include "unrolled_dllist.hxx"
+#include "concurrent_dllist.hxx"
+#include "dllist_stats.hxx"
+#include "dllist_io.hxx"
+#include "arena_dllist.hxx"
+#include <cstdint>
+#include <sstream>
+#include <thread>
 #include <vector>
 
 int main(int argc, char* argv[])
@@ -34,6 +42,8 @@ int main(int argc, char* argv[])
   dllist<int> something(n, 10);
   // use copy constructor
   dllist<int> j(something);
+  // a range is linked in as one pre-built chain
+  j.insert(j.begin(), { 1,2,3 });
   for (auto const& l : j) {
     std::cout << l << ' ';
   }
@@ -49,6 +59,142 @@ int main(int argc, char* argv[])
   std::cout << '\n';
   std::cout << blah.size() << '\n';
 
+  // sort, merge, splice and reverse relink nodes; nothing is copied
+  dllist<int> odds({ 9,3,7,1,5 });
+  dllist<int> evens({ 8,2,6,4,4 });
+  odds.sort();
+  evens.sort();
+  evens.unique();
+  odds.merge(evens);
+  odds.splice(odds.begin(), blah);
+  odds.reverse();
+  for (auto const& l : odds) {
+    std::cout << l << ' ';
+  }
+  std::cout << '\n';
+
+  // nodes come from a per-list slab pool and clear() releases whole slabs
+  dllist<int, dllist_pool_allocator<int>> pooled({ 3,1,4,1,5,9,2,6 });
+  pooled.pop_front();
+  pooled.push_back(5);
+  dllist<int, dllist_pool_allocator<int>> pooled_copy(pooled);
+  for (auto const& l : pooled_copy) {
+    std::cout << l << ' ';
+  }
+  std::cout << '\n';
+  pooled.clear();
+  pooled.push_front(7);
+  std::cout << pooled.front() << ' ' << pooled.size() << '\n';
+
+  // bulk builds reuse freed nodes first, so churn does not grow the pool
+  std::vector<int> batch(1000, 1);
+  pooled.assign(batch.begin(), batch.end());
+  pooled.assign(batch.begin(), batch.end());
+  auto pool_bytes = pooled.get_allocator().capacity_bytes();
+  for (int i = 0; i != 1000; ++i) {
+    pooled.assign(batch.begin(), batch.end());
+    pooled.insert(pooled.cend(), batch.begin(), batch.end());
+    pooled.erase(std::next(pooled.begin(), 1000), pooled.end());
+  }
+  assert(pooled.get_allocator().capacity_bytes() == pool_bytes);
+  std::cout << "pool bytes: " << pool_bytes << " -> "
+    << pooled.get_allocator().capacity_bytes() << '\n';
+
+  // lock-free queue: many producers push_back, one consumer pops
+  concurrent_dllist<int> queue;
+  queue.push_back(4);
+  queue.push_back(2);
+  int popped;
+  while (queue.try_pop_front(popped)) {
+    std::cout << popped << ' ';
+  }
+  std::cout << '\n';
+
+  // 8 producers each push 0, 1, 2, ... tagged with their number; the
+  // consumer must see every value of every producer exactly once, in order
+  std::size_t const producers = 8;
+  std::uint64_t const per_producer = 100000;
+  concurrent_dllist<std::uint64_t> mpsc;
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p != producers; ++p) {
+    threads.emplace_back([&mpsc, p, per_producer] {
+      for (std::uint64_t i = 0; i != per_producer; ++i) {
+        mpsc.push_back(std::uint64_t{p} << 32 | i);
+      }
+    });
+  }
+  std::vector<std::uint64_t> expected(producers, 0);
+  std::uint64_t received = 0;
+  std::uint64_t value;
+  while (received != producers * per_producer) {
+    if (mpsc.try_pop_front(value)) {
+      auto p = static_cast<std::size_t>(value >> 32);
+      assert(p < producers);
+      assert((value & 0xffffffffu) == expected[p]);   // no loss, no duplicate
+      ++expected[p];
+      ++received;
+    }
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  assert(!mpsc.try_pop_front(value));
+  std::cout << received << " values from " << producers << " producers, in order\n";
+
+  // 32-bit index links in one arena; the whole list can be memcpy'd
+  arena_dllist<int> arena{ 5, 6, 7 };
+  arena.push_front(4);
+  std::vector<unsigned char> arena_image(arena.image_size());
+  arena.image(arena_image.data());
+  auto arena_copy = arena_dllist<int>::from_image(arena_image.data(), arena_image.size());
+  for (auto const& l : arena_copy) {
+    std::cout << l << ' ';
+  }
+  std::cout << '\n';
+
+  // several elements per node: blocks split on insert and merge on erase
+  unrolled_dllist<int> packed({ 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 });
+  auto mid = packed.begin();
+  std::advance(mid, 8);
+  mid = packed.insert(mid, 100);
+  packed.erase(packed.begin());
+  for (auto const& l : packed) {
+    std::cout << l << ' ';
+  }
+  std::cout << '\n';
+
+  // erasing every other element merges half-empty blocks back into full ones
+  unrolled_dllist<int> sparse(1200, 1);
+  for (auto i = sparse.begin(); i != sparse.end(); ) {
+    i = sparse.erase(i);
+    if (i != sparse.end()) {
+      ++i;
+    }
+  }
+  auto const block_capacity = unrolled_dllist<int>::block_capacity;
+  assert(sparse.block_count() == (sparse.size() + block_capacity - 1) / block_capacity);
+  std::cout << sparse.size() << " elements in " << sparse.block_count() << " blocks\n";
+
+  // opt-in counters, collected in a process-wide registry
+  dllist<int, std::allocator<int>, dllist_counting_stats> counted{ 3, 1, 2 };
+  counted.stats().set_name("counted");
+  counted.push_back(4);
+  for (auto const& l : counted) {
+    std::cout << l << ' ';
+  }
+  std::cout << '\n';
+  dllist_stats_registry::instance().dump_text(std::cout);
+
+  // binary image: elements only, the XOR links are rebuilt on load
+  std::stringstream image(std::ios::in | std::ios::out | std::ios::binary);
+  dllist_serialize(image, j);
+  dllist<int, dllist_pool_allocator<int>> restored;
+  dllist_deserialize(image, restored);
+  for (auto const& l : restored) {
+    std::cout << l << ' ';
+  }
+  std::cout << '\n';
+
 
   return 0;
 }